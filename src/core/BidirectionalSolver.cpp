@@ -0,0 +1,326 @@
+// ========================= src/core/BidirectionalSolver.cpp =========================
+#include "BidirectionalSolver.hpp"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace ws {
+
+    namespace {
+
+        struct NodeRec {
+            uint64_t parent{ 0 }; // canonical key of the neighbour one layer closer to this side's root
+            Move move{};          // forward move parent->this (forward side) or this->parent (backward side)
+            int depth{ 0 };
+            int root{ -1 };       // backward side: goal state index the chain ends in
+        };
+
+        using NodeMap = std::unordered_map<uint64_t, NodeRec>;
+        using Frontier = std::vector<std::pair<uint64_t, std::string>>;
+
+        // One length byte per bottle followed by its colours bottom->top. Capacities and gimmicks
+        // never change during search, so they come from the template state on unpack.
+        std::string pack(const State& s) {
+            std::string out;
+            out.reserve(s.B.size() * 5);
+            for (const auto& b : s.B) {
+                out.push_back((char)b.slots.size());
+                for (const auto& sl : b.slots) out.push_back((char)sl.c);
+            }
+            return out;
+        }
+
+        void unpack(const std::string& packed, State& out) {
+            size_t pos = 0;
+            for (auto& b : out.B) {
+                const int n = (uint8_t)packed[pos++];
+                b.slots.resize(n);
+                for (int k = 0; k < n; ++k) b.slots[k] = Slot{ (Color)(uint8_t)packed[pos++], false };
+            }
+            out.refreshLocks();
+        }
+
+        // Inverse of a pour: move `amount` cells from the top of m.to back onto m.from.
+        void unpour(State& s, const Move& m) {
+            auto& f = s.B[m.from];
+            auto& t = s.B[m.to];
+            for (int i = 0; i < m.amount; ++i) {
+                f.slots.push_back(t.slots.back());
+                t.slots.pop_back();
+            }
+            s.refreshLocks();
+        }
+
+        bool sameContent(const Bottle& a, const Bottle& b) {
+            if (a.capacity != b.capacity || a.slots.size() != b.slots.size()) return false;
+            for (size_t k = 0; k < a.slots.size(); ++k) {
+                if (a.slots[k].c != b.slots[k].c) return false;
+            }
+            return true;
+        }
+
+        // Enumerate solved states modulo interchangeable-bottle permutations: pinned bottles
+        // get every colour (or empty) by position, free bottles take the leftovers in colour order.
+        bool enumerateGoals(const State& s, size_t limit, std::vector<State>& goals) {
+            if (s.B.empty()) return false;
+            const int cap = s.B[0].capacity;
+            std::array<int, 21> counts{};
+            for (const auto& b : s.B) {
+                if (b.capacity != cap) return false;
+                for (const auto& sl : b.slots) {
+                    if (sl.c < 1 || sl.c > 20) return false;
+                    ++counts[sl.c];
+                }
+            }
+
+            std::array<int, 21> units{};
+            int totalUnits = 0;
+            for (int c = 1; c <= 20; ++c) {
+                if (counts[c] % cap != 0) return false;
+                units[c] = counts[c] / cap;
+                totalUnits += units[c];
+            }
+            if (totalUnits > (int)s.B.size()) return false;
+
+            std::vector<int> pinned;
+            std::vector<int> freeIdx;
+            for (int i = 0; i < (int)s.B.size(); ++i) {
+                if (s.isInterchangeable(i)) freeIdx.push_back(i);
+                else pinned.push_back(i);
+            }
+
+            State goal = s;
+            for (auto& b : goal.B) b.slots.clear();
+            auto fill = [&](int bi, Color c) {
+                goal.B[bi].slots.assign(cap, Slot{ c,false });
+            };
+
+            bool overflow = false;
+            std::function<void(size_t, int)> assign = [&](size_t pi, int unitsLeft) {
+                if (overflow) return;
+                if (unitsLeft > (int)freeIdx.size() + (int)(pinned.size() - pi)) return;
+                if (pi == pinned.size()) {
+                    size_t fi = 0;
+                    for (int c = 1; c <= 20; ++c) {
+                        for (int u = 0; u < units[c]; ++u) fill(freeIdx[fi++], (Color)c);
+                    }
+                    goal.refreshLocks();
+                    if (goal.isSolved()) {
+                        if (goals.size() >= limit) { overflow = true; }
+                        else goals.push_back(goal);
+                    }
+                    for (size_t k = 0; k < fi; ++k) goal.B[freeIdx[k]].slots.clear();
+                    return;
+                }
+
+                const int bi = pinned[pi];
+                assign(pi + 1, unitsLeft);
+                for (int c = 1; c <= 20 && !overflow; ++c) {
+                    if (units[c] <= 0) continue;
+                    --units[c];
+                    fill(bi, (Color)c);
+                    assign(pi + 1, unitsLeft - 1);
+                    goal.B[bi].slots.clear();
+                    ++units[c];
+                }
+            };
+            assign(0, totalUnits);
+            return !overflow;
+        }
+
+    } // namespace
+
+    SolveResult BidirectionalSolver::solve(const State& start) {
+        using clock = std::chrono::steady_clock;
+        auto t0 = clock::now();
+        auto elapsedMs = [&] { return (int)std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - t0).count(); };
+        auto timeOk = [&] { return elapsedMs() < budgetMs; };
+
+        goalStates = 0;
+        nodes = 0;
+        fallback = false;
+
+        const State s0 = Solver::normalizeForSolve(start);
+        SolveResult result;
+        if (s0.isSolved()) {
+            result.solved = true;
+            result.minMoves = 0;
+            result.lowerBound = 0;
+            result.distinctSolutions = 1;
+            result.solutionCountExhaustive = true;
+            return result;
+        }
+
+        auto fallbackSolve = [&]() {
+            fallback = true;
+            Solver solver(std::max(1, budgetMs - elapsedMs()));
+            return solver.solve(start);
+        };
+
+        std::vector<State> goals;
+        if (!enumerateGoals(s0, goalLimit, goals) || goals.empty()) {
+            return fallbackSolve();
+        }
+        goalStates = goals.size();
+
+        NodeMap fwd, bwd;
+        fwd.reserve(1 << 14);
+        bwd.reserve(1 << 14);
+        Frontier fwdFrontier, bwdFrontier;
+
+        const uint64_t startKey = s0.canonicalHash();
+        fwd.emplace(startKey, NodeRec{ startKey, Move{}, 0, -1 });
+        fwdFrontier.emplace_back(startKey, pack(s0));
+        for (size_t gi = 0; gi < goals.size(); ++gi) {
+            const uint64_t key = goals[gi].canonicalHash();
+            if (bwd.emplace(key, NodeRec{ key, Move{}, 0, (int)gi }).second) {
+                bwdFrontier.emplace_back(key, pack(goals[gi]));
+            }
+        }
+
+        // Layered BFS, always growing the smaller frontier. With every node stored at its exact
+        // distance, the first key found on both sides lies on a shortest path: any shorter path
+        // would already have met in an earlier layer, so stopping here keeps the result optimal.
+        int fwdDepth = 0;
+        int bwdDepth = 0;
+        bool met = false;
+        bool budgetHit = false;
+        uint64_t meetKey = 0;
+        State scratch = s0;
+
+        while (!met && !budgetHit && !fwdFrontier.empty() && !bwdFrontier.empty()) {
+            const bool forward = fwdFrontier.size() <= bwdFrontier.size();
+            NodeMap& own = forward ? fwd : bwd;
+            const NodeMap& other = forward ? bwd : fwd;
+            Frontier& frontier = forward ? fwdFrontier : bwdFrontier;
+            int& depth = forward ? fwdDepth : bwdDepth;
+
+            Frontier next;
+            for (const auto& [parentKey, packed] : frontier) {
+                if ((++nodes & 255) == 0 && !timeOk()) { budgetHit = true; break; }
+                if (own.size() + other.size() > nodeLimit) { budgetHit = true; break; }
+
+                unpack(packed, scratch);
+                const int root = own.at(parentKey).root;
+                auto visit = [&](const State& child, const Move& m) {
+                    const uint64_t key = child.canonicalHash();
+                    if (!own.emplace(key, NodeRec{ parentKey, m, depth + 1, root }).second) return;
+                    if (other.count(key)) { met = true; meetKey = key; return; }
+                    next.emplace_back(key, pack(child));
+                };
+
+                const int n = (int)scratch.B.size();
+                if (forward) {
+                    for (int i = 0; i < n && !met; ++i) {
+                        for (int j = 0; j < n && !met; ++j) {
+                            int amt = 0;
+                            if (i == j || !scratch.canPour(i, j, &amt)) continue;
+                            State child = scratch;
+                            Move m{ i,j,amt };
+                            child.apply(m);
+                            visit(child, m);
+                        }
+                    }
+                }
+                else {
+                    for (int to = 0; to < n && !met; ++to) {
+                        const auto& bt = scratch.B[to];
+                        const int run = bt.topChunk();
+                        for (int k = 1; k <= run && !met; ++k) {
+                            // the cell left on top of `to` must accept the colour (or `to` must become empty)
+                            if (k == run && bt.size() > run) continue;
+                            for (int from = 0; from < n && !met; ++from) {
+                                if (from == to) continue;
+                                const auto& bf = scratch.B[from];
+                                if (bf.capacity - bf.size() < k) continue;
+                                Move m{ from,to,k };
+                                State prev = scratch;
+                                unpour(prev, m);
+                                int amt = 0;
+                                if (!prev.canPour(from, to, &amt) || amt != k) continue;
+                                visit(prev, m);
+                            }
+                        }
+                    }
+                }
+                if (met) break;
+            }
+            if (budgetHit) break;
+            ++depth;
+            frontier.swap(next);
+        }
+
+        if (!met) {
+            // Every path of length <= fwdDepth + bwdDepth has been ruled out.
+            result.timedOut = budgetHit;
+            result.minMoves = budgetHit ? fwdDepth + bwdDepth + 1 : -1;
+            result.lowerBound = budgetHit ? std::max(result.minMoves, Solver::runLowerBound(s0)) : -1;
+            return result;
+        }
+
+        // Forward half: start -> meeting state.
+        std::vector<Move> head;
+        for (uint64_t k = meetKey;;) {
+            const auto& r = fwd.at(k);
+            if (r.depth == 0) break;
+            head.push_back(r.move);
+            k = r.parent;
+        }
+        std::reverse(head.begin(), head.end());
+        State meetFwd = s0;
+        for (const auto& m : head) meetFwd.apply(m);
+
+        // Backward half: meeting state -> goal, expressed in the backward tree's bottle order.
+        std::vector<Move> tail;
+        int root = -1;
+        for (uint64_t k = meetKey;;) {
+            const auto& r = bwd.at(k);
+            if (r.depth == 0) { root = r.root; break; }
+            tail.push_back(r.move);
+            k = r.parent;
+        }
+        State meetBwd = goals[(size_t)root];
+        for (auto it = tail.rbegin(); it != tail.rend(); ++it) unpour(meetBwd, *it);
+
+        // Both halves agree only up to a permutation of interchangeable bottles; map it over.
+        const int n = (int)s0.B.size();
+        std::vector<int> perm(n, -1);
+        std::vector<bool> used(n, false);
+        for (int i = 0; i < n; ++i) {
+            if (!s0.isInterchangeable(i)) { perm[i] = i; used[i] = true; }
+        }
+        for (int i = 0; i < n; ++i) {
+            if (perm[i] >= 0) continue;
+            for (int j = 0; j < n; ++j) {
+                if (used[j] || !s0.isInterchangeable(j)) continue;
+                if (!sameContent(meetBwd.B[i], meetFwd.B[j])) continue;
+                perm[i] = j; used[j] = true;
+                break;
+            }
+            if (perm[i] < 0) return fallbackSolve();
+        }
+
+        std::vector<Move> path = std::move(head);
+        for (const auto& m : tail) path.push_back(Move{ perm[m.from], perm[m.to], m.amount });
+
+        // Replay guards against canonical-hash collisions.
+        State check = s0;
+        for (const auto& m : path) {
+            int amt = 0;
+            if (!check.canPour(m.from, m.to, &amt) || amt != m.amount) return fallbackSolve();
+            check.apply(m);
+        }
+        if (!check.isSolved()) return fallbackSolve();
+
+        result.solved = true;
+        result.minMoves = (int)path.size();
+        result.lowerBound = result.minMoves;
+        result.solutionMoves = std::move(path);
+        result.distinctSolutions = 1;
+        return result;
+    }
+
+} // namespace ws
@@ -0,0 +1,32 @@
+// ========================= src/core/BidirectionalSolver.hpp =========================
+#pragma once
+#include "Solver.hpp"
+
+namespace ws {
+
+    // Meet-in-the-middle search between the start state and the set of solved states.
+    // Forward layers use canPour/apply, backward layers use the inverse pour rule, and both
+    // sides deduplicate on State::canonicalHash(). Falls back to Solver::solve when the goal
+    // set cannot be enumerated (uneven colour counts, mixed capacities, too many goal states).
+    class BidirectionalSolver {
+    public:
+        explicit BidirectionalSolver(int timeBudgetMs = 2000, size_t maxGoalStates = 4096, size_t maxNodes = 4000000)
+            :budgetMs(timeBudgetMs), goalLimit(maxGoalStates), nodeLimit(maxNodes) {}
+
+        SolveResult solve(const State& start);
+
+        // Stats of the last solve() call.
+        size_t goalStateCount() const { return goalStates; }
+        size_t nodeCount() const { return nodes; }
+        bool usedFallback() const { return fallback; }
+
+    private:
+        int budgetMs{ 2000 };
+        size_t goalLimit{ 4096 };
+        size_t nodeLimit{ 4000000 };
+        size_t goalStates{ 0 };
+        size_t nodes{ 0 };
+        bool fallback{ false };
+    };
+
+} // namespace ws
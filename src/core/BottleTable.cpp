@@ -0,0 +1,78 @@
+// ========================= src/core/BottleTable.cpp =========================
+#include "BottleTable.hpp"
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <mutex>
+
+namespace ws {
+
+    namespace {
+        constexpr uint32_t kRadix = BottleTable::kMaxColor + 1;
+    }
+
+    BottleTable::BottleTable(int capacity) : cap(capacity) {
+        uint32_t count = 1;
+        for (int k = 0; k < cap; ++k) count *= kRadix;
+        entries.resize(count);
+
+        std::array<uint8_t, kMaxCapacity> cells{};
+        for (uint32_t c = 0; c < count; ++c) {
+            int height = 0;
+            bool packed = true;
+            for (uint32_t k = 0, v = c; k < (uint32_t)cap; ++k, v /= kRadix) {
+                cells[k] = (uint8_t)(v % kRadix);
+                if (cells[k] == 0) continue;
+                if (height != (int)k) packed = false;   // a colour above an empty cell
+                ++height;
+            }
+            if (!packed) continue;   // never produced by code(); left as an empty bottle
+
+            BottleInfo& e = entries[c];
+            e.height = (uint8_t)height;
+            if (height == 0) continue;
+            e.top = cells[(size_t)height - 1];
+            while (e.run < height && cells[(size_t)height - 1 - e.run] == e.top) ++e.run;
+            for (int k = 0; k < height; ++k) if (k == 0 || cells[(size_t)k] != cells[(size_t)k - 1]) ++e.groups;
+            e.monoFull = height == cap && e.groups == 1;
+            e.fragmentation = (uint8_t)(e.groups - 1);
+            e.heuristic = e.monoFull ? 0 : (uint8_t)std::max(1, e.groups - 1);
+        }
+    }
+
+    const BottleTable* BottleTable::forCapacity(int capacity) {
+        if (capacity < 1 || capacity > kMaxCapacity) return nullptr;
+        static std::once_flag once[kMaxCapacity];
+        static std::unique_ptr<BottleTable> tables[kMaxCapacity];
+        const int i = capacity - 1;
+        std::call_once(once[i], [&] { tables[i].reset(new BottleTable(capacity)); });
+        return tables[i].get();
+    }
+
+    const BottleTable* BottleTable::forState(const State& s) {
+        if (s.B.empty()) return nullptr;
+        const int capacity = s.B.front().capacity;
+        for (const auto& b : s.B) if (b.capacity != capacity) return nullptr;
+        return forCapacity(capacity);
+    }
+
+    uint32_t BottleTable::code(const Bottle& b) const {
+        if (b.capacity != cap || b.size() > cap) return kNoCode;
+        uint32_t c = 0;
+        for (int k = b.size() - 1; k >= 0; --k) {
+            const Slot& sl = b.slots[(size_t)k];
+            if (sl.hidden || sl.c == 0 || sl.c > kMaxColor) return kNoCode;
+            c = c * kRadix + sl.c;
+        }
+        return c;
+    }
+
+    bool BottleTable::encode(const State& s, std::vector<uint32_t>& out) const {
+        out.resize(s.B.size());
+        for (size_t i = 0; i < s.B.size(); ++i) {
+            if ((out[i] = code(s.B[i])) == kNoCode) return false;
+        }
+        return true;
+    }
+
+} // namespace ws
@@ -0,0 +1,52 @@
+// ========================= src/core/BottleTable.hpp =========================
+#pragma once
+#include "State.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace ws {
+
+    // Everything the solver reads from one bottle's contents, precomputed.
+    struct BottleInfo {
+        uint8_t height{ 0 };
+        uint8_t top{ 0 };            // top colour, 0 when empty
+        uint8_t run{ 0 };            // Bottle::topChunk()
+        uint8_t groups{ 0 };         // colour runs, bottom to top
+        uint8_t heuristic{ 0 };      // Solver::heuristicTerm()
+        uint8_t fragmentation{ 0 };  // groups - 1, as estimateDifficulty counts it
+        bool monoFull{ false };      // Bottle::isMonoFull()
+    };
+
+    // Lookup table over every content of a bottle of one small capacity. A content is packed
+    // bottom to top as sum(colour_k * 11^k), so empty cells above the top are zero digits and
+    // 11^capacity codes cover all bottles with colours 1..10 (14.6k at capacity 4, 1.77M at 6).
+    // Tables are built on first use and shared; bottles with '?' cells or colours above 10
+    // have no code and callers fall back to the Bottle member loops.
+    class BottleTable {
+    public:
+        static constexpr int kMaxCapacity = 6;
+        static constexpr int kMaxColor = 10;
+        static constexpr uint32_t kNoCode = 0xFFFFFFFFu;
+
+        // Shared table for `capacity`, or nullptr outside 1..kMaxCapacity. Thread-safe.
+        static const BottleTable* forCapacity(int capacity);
+        // Table for a board whose bottles all share one capacity, else nullptr.
+        static const BottleTable* forState(const State& s);
+
+        int capacity() const { return cap; }
+
+        // Packed code of `b`, or kNoCode when it cannot be looked up here.
+        uint32_t code(const Bottle& b) const;
+        // Codes for every bottle of `s`; false (and `out` unspecified) if any bottle has none.
+        bool encode(const State& s, std::vector<uint32_t>& out) const;
+
+        const BottleInfo& operator[](uint32_t c) const { return entries[c]; }
+
+    private:
+        explicit BottleTable(int capacity);
+
+        int cap{ 0 };
+        std::vector<BottleInfo> entries;
+    };
+
+} // namespace ws
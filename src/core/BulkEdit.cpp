@@ -0,0 +1,251 @@
+// ========================= src/core/BulkEdit.cpp =========================
+#include "BulkEdit.hpp"
+#include "BidirectionalSolver.hpp"
+#include <algorithm>
+#include <sstream>
+#include <thread>
+
+namespace ws {
+
+    namespace {
+
+        const char* gimmickWord(StackGimmickKind k) {
+            switch (k) {
+            case StackGimmickKind::Cloth: return "cloth";
+            case StackGimmickKind::Vine: return "vine";
+            case StackGimmickKind::Bush: return "bush";
+            default: return "none";
+            }
+        }
+
+        bool parseGimmickWord(const std::string& w, StackGimmickKind& out) {
+            for (auto k : { StackGimmickKind::None, StackGimmickKind::Cloth, StackGimmickKind::Vine, StackGimmickKind::Bush }) {
+                if (w == gimmickWord(k)) { out = k; return true; }
+            }
+            return false;
+        }
+
+        // Same placement rule as the generator: never the top cell, and not the cell right below
+        // the top when it has the top's colour.
+        bool canHide(const Bottle& b, int idx) {
+            const int top = (int)b.slots.size() - 1;
+            if (idx < 0 || idx >= top || b.slots[idx].hidden) return false;
+            if (idx + 1 == top && b.slots[idx].c == b.slots[top].c) return false;
+            return true;
+        }
+
+        bool applyOp(State& s, const BulkOp& op, std::string& why) {
+            if (op.bottle < 0 || op.bottle >= (int)s.B.size()) { why = "bottle out of range"; return false; }
+            auto& b = s.B[op.bottle];
+            switch (op.kind) {
+            case BulkOp::Kind::SetGimmick:
+                if (op.gimmick == StackGimmickKind::Cloth && (op.clothTarget < 1 || op.clothTarget > s.p.numColors)) {
+                    why = "cloth target out of range"; return false;
+                }
+                b.gimmick.kind = op.gimmick;
+                b.gimmick.clothTarget = op.gimmick == StackGimmickKind::Cloth ? op.clothTarget : 0;
+                return true;
+            case BulkOp::Kind::SetClothTarget:
+                if (b.gimmick.kind != StackGimmickKind::Cloth) { why = "bottle has no cloth"; return false; }
+                if (op.clothTarget < 1 || op.clothTarget > s.p.numColors) { why = "cloth target out of range"; return false; }
+                b.gimmick.clothTarget = op.clothTarget;
+                return true;
+            case BulkOp::Kind::HideCells: {
+                int left = op.count;
+                for (int idx = (int)b.slots.size() - 2; idx >= 0 && left > 0; --idx) {
+                    if (!canHide(b, idx)) continue;
+                    b.slots[idx].hidden = true;
+                    --left;
+                }
+                if (left > 0) { why = "not enough cells to hide"; return false; }
+                return true;
+            }
+            }
+            return false;
+        }
+
+    } // namespace
+
+    bool parseBulkTransform(const std::string& text, BulkTransform& out, std::string* reason) {
+        auto fail = [&](const std::string& why) {
+            if (reason) *reason = why;
+            return false;
+        };
+        BulkTransform t;
+        std::istringstream all(text);
+        std::string part;
+        while (std::getline(all, part, ';')) {
+            std::istringstream in(part);
+            std::string verb;
+            if (!(in >> verb)) continue;
+            BulkOp op;
+            int bottle = 0;
+            if (!(in >> bottle) || bottle < 1) return fail("'" + part + "': expected a bottle number (1-based)");
+            op.bottle = bottle - 1;
+            if (verb == "gimmick") {
+                std::string kind;
+                if (!(in >> kind) || !parseGimmickWord(kind, op.gimmick)) return fail("'" + part + "': expected none|cloth|vine|bush");
+                op.kind = BulkOp::Kind::SetGimmick;
+                if (op.gimmick == StackGimmickKind::Cloth) {
+                    int target = 0;
+                    if (!(in >> target)) return fail("'" + part + "': cloth needs a target colour");
+                    op.clothTarget = (Color)std::clamp(target, 0, 255);
+                }
+            }
+            else if (verb == "hide") {
+                op.kind = BulkOp::Kind::HideCells;
+                if (!(in >> op.count) || op.count < 1) return fail("'" + part + "': expected a cell count");
+            }
+            else if (verb == "cloth") {
+                op.kind = BulkOp::Kind::SetClothTarget;
+                int target = 0;
+                if (!(in >> target)) return fail("'" + part + "': expected a target colour");
+                op.clothTarget = (Color)std::clamp(target, 0, 255);
+            }
+            else {
+                return fail("Unknown op '" + verb + "'");
+            }
+            t.ops.push_back(op);
+        }
+        if (t.ops.empty()) return fail("No ops given.");
+        out = std::move(t);
+        return true;
+    }
+
+    std::string describeBulkTransform(const BulkTransform& t) {
+        std::ostringstream oss;
+        for (size_t i = 0; i < t.ops.size(); ++i) {
+            const auto& op = t.ops[i];
+            if (i > 0) oss << "; ";
+            switch (op.kind) {
+            case BulkOp::Kind::SetGimmick:
+                oss << "gimmick " << (op.bottle + 1) << ' ' << gimmickWord(op.gimmick);
+                if (op.gimmick == StackGimmickKind::Cloth) oss << ' ' << int(op.clothTarget);
+                break;
+            case BulkOp::Kind::HideCells: oss << "hide " << (op.bottle + 1) << ' ' << op.count; break;
+            case BulkOp::Kind::SetClothTarget: oss << "cloth " << (op.bottle + 1) << ' ' << int(op.clothTarget); break;
+            }
+        }
+        return oss.str();
+    }
+
+    bool applyBulkTransform(State& s, const BulkTransform& t, std::string* reason) {
+        State edited = s;
+        for (const auto& op : t.ops) {
+            std::string why;
+            if (!applyOp(edited, op, why)) {
+                if (reason) *reason = "bottle " + std::to_string(op.bottle + 1) + ": " + why;
+                return false;
+            }
+        }
+        edited.refreshLocks();
+        s = std::move(edited);
+        return true;
+    }
+
+    const char* bulkOutcomeName(BulkOutcome o) {
+        switch (o) {
+        case BulkOutcome::Unchanged: return "Unchanged";
+        case BulkOutcome::MovesChanged: return "Moves changed";
+        case BulkOutcome::BandChanged: return "Band changed";
+        case BulkOutcome::Unsolvable: return "Unsolvable";
+        case BulkOutcome::Unverified: return "Unverified";
+        case BulkOutcome::TransformFailed: return "Transform failed";
+        }
+        return "?";
+    }
+
+    namespace {
+
+        BulkReport revalidate(Generated& g, const BulkTransform& t, const BulkOptions& opt, int countWorkers) {
+            BulkReport rep;
+            rep.oldMoves = g.minMoves;
+            rep.oldLabel = g.diffLabel;
+
+            State s = g.state;
+            if (!applyBulkTransform(s, t, &rep.reason)) {
+                rep.outcome = BulkOutcome::TransformFailed;
+                return rep;
+            }
+
+            Solver solver(opt.solveTimeMs, countWorkers);
+            auto res = solver.solve(s, g.solutionMoves);
+            if (!res.solved && res.solutionMoves.empty()) {
+                // The old line no longer works and IDA* cannot tell "unsolvable" from "too slow";
+                // the bidirectional search can prove the former.
+                auto proof = BidirectionalSolver(opt.solveTimeMs).solve(s);
+                if (proof.solved) {
+                    res = std::move(proof);
+                }
+                else {
+                    const bool proven = !proof.timedOut && proof.minMoves < 0;
+                    rep.outcome = proven ? BulkOutcome::Unsolvable : BulkOutcome::Unverified;
+                    rep.reason = proven ? "no solution after the edit" : "solver budget exhausted";
+                    if (opt.keepUnsolvable) {
+                        g.state = std::move(s);
+                        g.minMoves = -1;
+                        g.solutionMoves.clear();
+                    }
+                    return rep;
+                }
+            }
+
+            Generated next = g;
+            next.state = std::move(s);
+            next.minMoves = res.minMoves;
+            next.minMovesExact = res.solved && res.lowerBound >= res.minMoves;
+            next.minMovesLowerBound = next.minMovesExact ? res.minMoves : res.lowerBound;
+            next.diffScore = solver.estimateDifficulty(next.state, res);
+            next.diffLabel = labelForScore(next.diffScore);
+            next.solutionMoves = std::move(res.solutionMoves);
+            next.difficulty = res.difficulty;
+            // The scramble replay belongs to the unedited board.
+            next.scrambleStart = State{};
+            next.scrambleMoves.clear();
+
+            rep.newMoves = next.minMoves;
+            rep.newMovesExact = next.minMovesExact;
+            rep.newLabel = next.diffLabel;
+            if (rep.newLabel != rep.oldLabel) rep.outcome = BulkOutcome::BandChanged;
+            else if (rep.newMoves != rep.oldMoves) rep.outcome = BulkOutcome::MovesChanged;
+            else rep.outcome = BulkOutcome::Unchanged;
+            if (!next.minMovesExact) rep.reason = "upper bound only, lower bound " + std::to_string(next.minMovesLowerBound);
+            g = std::move(next);
+            return rep;
+        }
+
+    } // namespace
+
+    std::vector<BulkReport> runBulkTransform(std::vector<Generated>& maps, const std::vector<int>& indices,
+        const BulkTransform& t, const BulkOptions& opt, std::atomic<int>* progress) {
+        std::vector<BulkReport> reports(indices.size());
+        std::atomic<size_t> nextJob{ 0 };
+        const int workerCount = std::clamp(opt.workers, 1, std::max(1, (int)indices.size()));
+        // Fewer maps than workers (e.g. "current map only"): the spare threads help count solutions.
+        const int countWorkers = std::max(1, opt.workers / workerCount);
+        auto work = [&] {
+            while (true) {
+                const size_t k = nextJob.fetch_add(1);
+                if (k >= indices.size()) break;
+                const int idx = indices[k];
+                if (idx < 0 || idx >= (int)maps.size()) {
+                    reports[k].outcome = BulkOutcome::TransformFailed;
+                    reports[k].reason = "map index out of range";
+                }
+                else {
+                    reports[k] = revalidate(maps[idx], t, opt, countWorkers);
+                }
+                reports[k].index = idx;
+                if (progress) progress->fetch_add(1);
+            }
+        };
+
+        std::vector<std::thread> workers;
+        workers.reserve((size_t)workerCount - 1);
+        for (int w = 1; w < workerCount; ++w) workers.emplace_back(work);
+        work();
+        for (auto& w : workers) w.join();
+        return reports;
+    }
+
+} // namespace ws
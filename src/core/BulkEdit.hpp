@@ -0,0 +1,69 @@
+// ========================= src/core/BulkEdit.hpp =========================
+#pragma once
+#include "Generator.hpp"
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace ws {
+
+    // One declarative edit. Bottles are 0-based here; the text form uses the 1-based numbers the UI shows.
+    struct BulkOp {
+        enum class Kind { SetGimmick, HideCells, SetClothTarget };
+        Kind kind{ Kind::SetGimmick };
+        int bottle{ 0 };
+        StackGimmickKind gimmick{ StackGimmickKind::None }; // SetGimmick
+        Color clothTarget{ 0 };                             // SetGimmick with Cloth, SetClothTarget
+        int count{ 0 };                                     // HideCells: '?' cells to add, from just below the top downwards
+    };
+
+    struct BulkTransform {
+        std::vector<BulkOp> ops;
+    };
+
+    // Text form, ops separated by ';':
+    //   gimmick <bottle> none|cloth|vine|bush [clothTarget]
+    //   hide <bottle> <count>
+    //   cloth <bottle> <target>
+    bool parseBulkTransform(const std::string& text, BulkTransform& out, std::string* reason = nullptr);
+    std::string describeBulkTransform(const BulkTransform& t);
+
+    // Applies every op in order. Fails, leaving `s` untouched, when an op does not fit the map
+    // (bottle out of range, not enough cells to hide, cloth target on a non-cloth bottle, ...).
+    bool applyBulkTransform(State& s, const BulkTransform& t, std::string* reason = nullptr);
+
+    enum class BulkOutcome {
+        Unchanged,       // same move count and band
+        MovesChanged,    // move count changed, band kept
+        BandChanged,     // difficulty label changed
+        Unsolvable,      // proven to have no solution after the edit
+        Unverified,      // solver ran out of time without a solution or a proof
+        TransformFailed, // ops did not apply; map left as it was
+    };
+    const char* bulkOutcomeName(BulkOutcome o);
+
+    struct BulkReport {
+        int index{ -1 };            // index into the map list
+        BulkOutcome outcome{ BulkOutcome::Unchanged };
+        int oldMoves{ -1 };
+        int newMoves{ -1 };
+        bool newMovesExact{ true };
+        std::string oldLabel;
+        std::string newLabel;
+        std::string reason;
+    };
+
+    struct BulkOptions {
+        int solveTimeMs{ 2500 };
+        int workers{ 1 };
+        bool keepUnsolvable{ false }; // write unsolvable/unverified results back instead of keeping the original
+    };
+
+    // Transforms maps[i] for each i in `indices` and re-solves them on `workers` threads, using each
+    // map's stored solution as the solver's upper bound. Maps whose result is Unsolvable, Unverified
+    // or TransformFailed keep their original contents unless keepUnsolvable is set. `progress`, when
+    // given, is bumped once per finished map. Reports come back in `indices` order; indices must be distinct.
+    std::vector<BulkReport> runBulkTransform(std::vector<Generated>& maps, const std::vector<int>& indices,
+        const BulkTransform& t, const BulkOptions& opt = {}, std::atomic<int>* progress = nullptr);
+
+} // namespace ws
@@ -0,0 +1,204 @@
+// ========================= src/core/CpuGovernor.cpp =========================
+#include "CpuGovernor.hpp"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fstream>
+#include <string>
+#include <time.h>
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#endif
+
+namespace ws {
+
+    namespace {
+
+#ifdef _WIN32
+        uint64_t ticks(const FILETIME& f) { return (uint64_t)f.dwHighDateTime << 32 | f.dwLowDateTime; }
+
+        uint64_t processCpuNs() {
+            FILETIME created, exited, kernel, user;
+            if (!GetProcessTimes(GetCurrentProcess(), &created, &exited, &kernel, &user)) return 0;
+            return (ticks(kernel) + ticks(user)) * 100;
+        }
+
+        bool machineTicks(uint64_t& busy, uint64_t& total) {
+            FILETIME idle, kernel, user;
+            if (!GetSystemTimes(&idle, &kernel, &user)) return false;
+            total = ticks(kernel) + ticks(user);   // kernel time includes idle time
+            busy = total - ticks(idle);
+            return true;
+        }
+#else
+        uint64_t processCpuNs() {
+            timespec ts{};
+            if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) != 0) return 0;
+            return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+        }
+
+        bool machineTicks(uint64_t& busy, uint64_t& total) {
+#ifdef __linux__
+            // First line of /proc/stat: "cpu user nice system idle iowait irq softirq steal ...".
+            std::ifstream f("/proc/stat");
+            std::string label;
+            if (!(f >> label) || label != "cpu") return false;
+            uint64_t v[8]{};
+            for (auto& x : v) if (!(f >> x)) return false;
+            total = 0;
+            for (auto x : v) total += x;
+            busy = total - v[3] - v[4];
+            return true;
+#else
+            (void)busy; (void)total;
+            return false;
+#endif
+        }
+#endif
+
+    } // namespace
+
+    CpuGovernor::CpuGovernor() {
+        last.logicalCores = logicalCores();
+    }
+
+    int CpuGovernor::logicalCores() {
+        return std::max(1, (int)std::thread::hardware_concurrency());
+    }
+
+    void CpuGovernor::setOptions(const CpuGovernorOptions& o) {
+        std::lock_guard<std::mutex> lock(m);
+        opt = o;
+        updateAllowanceLocked();
+        cv.notify_all();
+    }
+
+    CpuGovernorOptions CpuGovernor::options() const {
+        std::lock_guard<std::mutex> lock(m);
+        return opt;
+    }
+
+    void CpuGovernor::begin(int workerCount) {
+        std::lock_guard<std::mutex> lock(m);
+        active = true;
+        workers = std::max(0, workerCount);
+        parked = 0;
+        updateAllowanceLocked();
+    }
+
+    void CpuGovernor::end() {
+        std::lock_guard<std::mutex> lock(m);
+        active = false;
+        cv.notify_all();
+    }
+
+    void CpuGovernor::gate(int index, const std::function<bool()>& done) {
+        std::unique_lock<std::mutex> lock(m);
+        if (!active) return;
+        const auto period = std::chrono::milliseconds(std::max(50, opt.sampleMs));
+        auto within = [&] {
+            if (index < allowed) return true;
+            // The partial worker runs for the first `duty` of every period.
+            return index == allowed && clock::now() - lastSample < std::chrono::duration<double, std::milli>(duty * (double)period.count());
+        };
+        if (clock::now() - lastSample >= period) sampleLocked(clock::now());
+        while (active && !within() && !(done && done())) {
+            ++parked;
+            cv.wait_until(lock, lastSample + period);
+            --parked;
+            if (clock::now() - lastSample >= period) sampleLocked(clock::now());
+        }
+    }
+
+    void CpuGovernor::enterWorker() const {
+        if (!options().lowPriority) return;
+#ifdef _WIN32
+        SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_LOWEST);
+#elif defined(__linux__)
+        // Linux applies nice values per thread; the UI thread keeps its priority.
+        setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), 10);
+#endif
+    }
+
+    CpuUsage CpuGovernor::usage() {
+        std::lock_guard<std::mutex> lock(m);
+        if (clock::now() - lastSample >= std::chrono::milliseconds(std::max(50, opt.sampleMs))) sampleLocked(clock::now());
+        CpuUsage u = last;
+        u.workers = active ? workers : 0;
+        u.allowedWorkers = active ? allowed : 0;
+        u.partialDuty = active ? duty : 0.0;
+        u.parkedWorkers = parked;
+        return u;
+    }
+
+    void CpuGovernor::sampleLocked(clock::time_point now) {
+        const uint64_t processNs = processCpuNs();
+        uint64_t busy = 0, total = 0;
+        const bool machine = machineTicks(busy, total);
+        if (lastSample != clock::time_point{}) {
+            const double wallNs = std::chrono::duration<double, std::nano>(now - lastSample).count();
+            if (wallNs > 0.0) last.processCores = (double)(processNs - lastProcessNs) / wallNs;
+            if (machine && haveMachine && total > lastTotal) {
+                last.machineCores = (double)(busy - lastBusy) / (double)(total - lastTotal) * last.logicalCores;
+            }
+            // Attribute the job's CPU to the workers that were not parked; counting threads a
+            // worker spawns show up as more than one core per worker.
+            const double running = active ? std::min((double)workers, allowed + duty) : 0.0;
+            if (running > 0.05 && last.processCores > 0.05) {
+                const double measured = std::clamp(last.processCores / running, 0.2, 8.0);
+                perWorker = 0.7 * perWorker + 0.3 * measured;
+            }
+        }
+        lastSample = now;
+        lastProcessNs = processNs;
+        lastBusy = busy;
+        lastTotal = total;
+        haveMachine = machine;
+        updateAllowanceLocked();
+    }
+
+    void CpuGovernor::updateAllowanceLocked() {
+        const int before = allowed;
+        const double cores = (double)last.logicalCores;
+        double budget = (double)workers * perWorker;
+        double minimum = 0.1;   // a capped job still makes some progress
+        switch (opt.mode) {
+        case CpuCapMode::Share: budget = std::clamp(opt.share, 0.0, 1.0) * cores; break;
+        case CpuCapMode::Cores: budget = std::max(1, opt.cores); break;
+        case CpuCapMode::IdleOnly: {
+            // Without a machine-wide figure this degrades to "all cores but the headroom".
+            const double others = last.machineCores >= 0.0 ? std::max(0.0, last.machineCores - last.processCores) : 0.0;
+            budget = std::max(0.0, cores - others - std::max(0.0, opt.headroom));
+            minimum = 0.0;
+            break;
+        }
+        default: break;
+        }
+        last.budgetCores = budget;
+        if (opt.mode == CpuCapMode::Off) {
+            allowed = workers;
+            duty = 0.0;
+        }
+        else {
+            const double units = std::clamp(budget / perWorker, minimum, (double)workers);
+            allowed = (int)std::floor(units + 1e-6);
+            duty = allowed < workers ? units - allowed : 0.0;
+            if (duty < 0.02) duty = 0.0;
+        }
+        if (allowed > before || duty > 0.0) cv.notify_all();
+    }
+
+} // namespace ws
@@ -0,0 +1,104 @@
+// ========================= src/core/CpuGovernor.hpp =========================
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+namespace ws {
+
+    enum class CpuCapMode : uint8_t {
+        Off = 0,        // every worker runs; usage is still sampled for display
+        Share = 1,      // a fraction of the machine's logical cores
+        Cores = 2,      // a fixed number of cores
+        IdleOnly = 3,   // whatever other processes leave idle, minus some headroom
+    };
+    constexpr int kCpuCapModeCount = 4;
+
+    inline const char* cpuCapModeName(CpuCapMode m) {
+        switch (m) {
+        case CpuCapMode::Share: return "Share of machine";
+        case CpuCapMode::Cores: return "Core count";
+        case CpuCapMode::IdleOnly: return "Idle cores only";
+        default: return "Off";
+        }
+    }
+
+    struct CpuGovernorOptions {
+        CpuCapMode mode{ CpuCapMode::Off };
+        double share{ 0.5 };         // Share: fraction of logical cores the job may keep busy
+        int cores{ 2 };              // Cores: cores the job may keep busy
+        double headroom{ 1.0 };      // IdleOnly: cores left free on top of other processes' use
+        bool lowPriority{ false };   // workers run below normal OS scheduling priority
+        int sampleMs{ 500 };
+    };
+
+    struct CpuUsage {
+        int logicalCores{ 1 };
+        double processCores{ 0.0 };   // cores this process kept busy over the last sample
+        double machineCores{ -1.0 };  // all processes; negative where the platform gives no figure
+        double budgetCores{ 0.0 };    // what the governor lets the job use right now
+        int workers{ 0 };
+        int allowedWorkers{ 0 };
+        double partialDuty{ 0.0 };    // share of each sample period worker #allowedWorkers may run
+        int parkedWorkers{ 0 };
+    };
+
+    // Holds a pool of generation workers to a CPU budget. Workers call gate() between attempts;
+    // a worker whose index is at or above the current allowance parks there until the budget
+    // grows again, so nothing is interrupted mid-solve. Process and machine CPU time are sampled
+    // every sampleMs by whichever worker passes a gate (parked ones wake on the same period), and
+    // the allowance is the budget divided by the measured cores per running worker. The fraction
+    // left over goes to one more worker as a duty cycle: it runs for that share of each period.
+    // Options may change while a run is in progress.
+    class CpuGovernor {
+    public:
+        CpuGovernor();
+        CpuGovernor(const CpuGovernor&) = delete;
+        CpuGovernor& operator=(const CpuGovernor&) = delete;
+
+        void setOptions(const CpuGovernorOptions& o);
+        CpuGovernorOptions options() const;
+
+        // Starts a run of `workers`; all are allowed until the first sample says otherwise.
+        void begin(int workers);
+        // Releases every parked worker; gate() passes straight through until the next begin().
+        void end();
+
+        // Worker `index` between attempts. Returns when it is within the allowance, the run has
+        // ended, or `done` reports that there is nothing left to do.
+        void gate(int index, const std::function<bool()>& done = {});
+        // Once per worker thread, before its first attempt: applies lowPriority.
+        void enterWorker() const;
+
+        // Latest sample, refreshed here as well when it is older than sampleMs, so the figures
+        // stay live between runs.
+        CpuUsage usage();
+
+        static int logicalCores();
+
+    private:
+        using clock = std::chrono::steady_clock;
+
+        void sampleLocked(clock::time_point now);
+        void updateAllowanceLocked();
+
+        mutable std::mutex m;
+        std::condition_variable cv;
+        CpuGovernorOptions opt;
+        bool active{ false };
+        int workers{ 0 };
+        int allowed{ 0 };
+        int parked{ 0 };
+        double duty{ 0.0 };          // partial worker's share of each period
+        double perWorker{ 1.0 };     // smoothed cores one running worker keeps busy
+        CpuUsage last;
+        clock::time_point lastSample{};
+        uint64_t lastProcessNs{ 0 };
+        uint64_t lastBusy{ 0 };
+        uint64_t lastTotal{ 0 };
+        bool haveMachine{ false };
+    };
+
+} // namespace ws
@@ -0,0 +1,205 @@
+// ========================= src/core/FixedSolver.cpp =========================
+#include "FixedSolver.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace ws {
+
+    namespace {
+
+        size_t align8(size_t v) { return (v + 7) & ~(size_t)7; }
+
+        // Fixed part of the block: board arrays, path stack, cursors and the move table.
+        size_t fixedBytes(const Params& p, int maxDepth, size_t stepSize) {
+            size_t used = align8(PackedBatch::bytesFor(1, p.numBottles, p.capacity));
+            used = align8(used + stepSize * (size_t)maxDepth);
+            used = align8(used + sizeof(uint16_t) * (size_t)(maxDepth + 1));
+            used = align8(used + (size_t)p.numBottles * p.numBottles);
+            return used;
+        }
+
+        constexpr size_t kMinTableEntries = 64;
+        constexpr int kNoBound = 1 << 30;
+
+    } // namespace
+
+    size_t FixedSolver::requiredBytes(const Params& p, int maxDepth, size_t tableEntries) {
+        const int depth = std::max(1, maxDepth);
+        return 7 + fixedBytes(p, depth, sizeof(Step)) + sizeof(TableEntry) * std::max(tableEntries, kMinTableEntries);
+    }
+
+    FixedSolver::FixedSolver(void* memory, size_t bytes, const Params& p, FixedSolveOptions o)
+        :params(p), opt(o) {
+        opt.maxDepth = std::clamp(opt.maxDepth, 1, 250);
+        if (!memory || p.numBottles <= 0 || p.capacity <= 0 || p.capacity > 255) return;
+
+        // Align the caller's block, then carve it front to back.
+        auto* raw = static_cast<uint8_t*>(memory);
+        const size_t skew = (8 - (reinterpret_cast<uintptr_t>(raw) & 7)) & 7;
+        if (bytes < skew) return;
+        uint8_t* base = raw + skew;
+        bytes -= skew;
+
+        const size_t fixed = fixedBytes(p, opt.maxDepth, sizeof(Step));
+        if (bytes < fixed + sizeof(TableEntry) * kMinTableEntries) return;
+
+        size_t used = 0;
+        board.bind(base, 1, p.numBottles, p.capacity);
+        used = align8(PackedBatch::bytesFor(1, p.numBottles, p.capacity));
+        path = reinterpret_cast<Step*>(base + used);
+        used = align8(used + sizeof(Step) * (size_t)opt.maxDepth);
+        cursor = reinterpret_cast<uint16_t*>(base + used);
+        used = align8(used + sizeof(uint16_t) * (size_t)(opt.maxDepth + 1));
+        amounts = base + used;
+        used = align8(used + (size_t)p.numBottles * p.numBottles);
+
+        // Largest power-of-two bucket count (two entries per bucket) that fits what is left.
+        const size_t entries = (bytes - used) / sizeof(TableEntry);
+        size_t buckets = 1;
+        while (buckets * 4 <= entries) buckets *= 2;
+        table = reinterpret_cast<TableEntry*>(base + used);
+        tableBuckets = buckets;
+    }
+
+    bool FixedSolver::seenAtOrAbove(int g) {
+        const uint64_t k = board.key[0];
+        const uint32_t check = (uint32_t)(k >> 32);
+        TableEntry* bucket = &table[(k & (tableBuckets - 1)) * 2];
+
+        auto live = [&](const TableEntry& e) { return e.used && e.iteration == iteration; };
+        TableEntry* victim = nullptr;
+        for (int i = 0; i < 2; ++i) {
+            auto& e = bucket[i];
+            if (live(e) && e.check == check) {
+                if (e.g <= g) return true;
+                e.g = (uint8_t)g;
+                ++lastStats.tableStores;
+                return false;
+            }
+            // Prefer a free or stale slot, else the deepest live one (cheapest to recompute).
+            if (!victim || (live(*victim) && (!live(e) || e.g > victim->g))) victim = &e;
+        }
+        if (live(*victim) && victim->g <= g) {
+            ++lastStats.tableRejects;
+            return false;
+        }
+        *victim = TableEntry{ check, iteration, (uint8_t)g, 1 };
+        ++lastStats.tableStores;
+        return false;
+    }
+
+    SolveResult FixedSolver::solve(const State& start) {
+        SolveResult out;
+        out.solutionMoves.reserve(opt.maxDepth);
+        solve(start, out, nullptr);
+        return out;
+    }
+
+    bool FixedSolver::solve(const State& start, SolveResult& out, std::string* reason) {
+        out.solved = false;
+        out.timedOut = false;
+        out.minMoves = -1;
+        out.lowerBound = -1;
+        out.distinctSolutions = 0;
+        out.solutionCountExhaustive = false;
+        out.solutionCountLimited = false;
+        out.solutionMoves.clear();
+        out.difficulty = SolveResult::DifficultyBreakdown{};
+        lastStats = FixedSolveStats{};
+        lastStats.tableEntries = tableBuckets * 2;
+
+        if (!ready()) {
+            if (reason) *reason = "Memory block too small for this board shape.";
+            return false;
+        }
+        if ((int)start.B.size() != params.numBottles || start.B[0].capacity != params.capacity) {
+            if (reason) *reason = "Board does not match the solver Params.";
+            return false;
+        }
+        if (!isPackable(start, reason)) return false;
+
+        board.load(0, start);
+        std::memset(static_cast<void*>(table), 0, sizeof(TableEntry) * tableBuckets * 2);
+        iteration = 0;
+
+        const int n = params.numBottles;
+        const int pairs = n * n;
+        int iterBound = board.bound[0];
+        if (iterBound == 0) {
+            out.solved = true;
+            out.minMoves = 0;
+            out.lowerBound = 0;
+            out.distinctSolutions = 1;
+            out.solutionCountExhaustive = true;
+            return true;
+        }
+
+        // IDA* with an explicit move stack; the pour table is rebuilt only after the board changes.
+        bool budgetHit = false;
+        bool depthCut = false;
+        while (true) {
+            ++iteration;
+            int nextBound = kNoBound;
+            depthCut = false;
+            int d = 0;
+            cursor[0] = 0;
+            seenAtOrAbove(0);
+            bool dirty = true;
+
+            while (true) {
+                if (dirty) { board.pourAmounts(amounts, 1); dirty = false; }
+
+                bool moved = false;
+                for (int p = cursor[d]; p < pairs && !moved; ++p) {
+                    const uint8_t amt = amounts[p];
+                    if (amt == 0) continue;
+                    const int from = p / n;
+                    const int to = p % n;
+                    if (d > 0 && path[d - 1].from == to && path[d - 1].to == from && path[d - 1].amount == amt) continue;
+                    cursor[d] = (uint16_t)(p + 1);
+
+                    board.moveCells(0, from, to, amt);
+                    ++lastStats.nodes;
+                    const int h = board.bound[0];
+                    const int f = d + 1 + h;
+                    if (h == 0) {
+                        path[d] = Step{ (uint8_t)from, (uint8_t)to, amt };
+                        out.solved = true;
+                        out.minMoves = d + 1;
+                        out.lowerBound = d + 1;
+                        out.distinctSolutions = 1;
+                        for (int k = 0; k <= d; ++k) out.solutionMoves.push_back(Move{ path[k].from, path[k].to, path[k].amount });
+                        return true;
+                    }
+                    if (f > iterBound || d + 1 >= opt.maxDepth || seenAtOrAbove(d + 1)) {
+                        if (f > iterBound) nextBound = std::min(nextBound, f);
+                        else if (d + 1 >= opt.maxDepth) depthCut = true;
+                        board.moveCells(0, to, from, amt);
+                        continue;
+                    }
+                    path[d] = Step{ (uint8_t)from, (uint8_t)to, amt };
+                    ++d;
+                    cursor[d] = 0;
+                    moved = true;
+                }
+                if (lastStats.nodes >= opt.nodeLimit) { budgetHit = true; break; }
+                if (moved) { dirty = true; continue; }
+
+                if (d == 0) break;
+                --d;
+                board.moveCells(0, path[d].to, path[d].from, path[d].amount);
+                dirty = true;
+            }
+
+            if (budgetHit || nextBound == kNoBound) break;
+            iterBound = nextBound;
+        }
+
+        // Every iteration below iterBound was exhausted: no shorter solution exists.
+        out.timedOut = budgetHit || depthCut;
+        out.minMoves = out.timedOut ? iterBound : -1;
+        out.lowerBound = iterBound;
+        return true;
+    }
+
+} // namespace ws
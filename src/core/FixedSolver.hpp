@@ -0,0 +1,62 @@
+// ========================= src/core/FixedSolver.hpp =========================
+#pragma once
+#include "PackedState.hpp"
+#include "Solver.hpp"
+#include <string>
+
+namespace ws {
+
+    struct FixedSolveOptions {
+        uint64_t nodeLimit{ 1000000 }; // hard per-call cap; the only stopping rule, so runs are reproducible
+        int maxDepth{ 64 };            // longest solution searched for
+    };
+
+    struct FixedSolveStats {
+        uint64_t nodes{ 0 };
+        size_t tableEntries{ 0 };   // slots the block had room for
+        uint64_t tableStores{ 0 };
+        uint64_t tableRejects{ 0 }; // boards not recorded because both bucket slots held shallower ones
+    };
+
+    // IDA* over a single packed board that never touches the heap after construction. The board
+    // arrays, path stack, move buffer and transposition table are all carved out of one
+    // caller-supplied block, so memory is fixed and, with no clock in the loop, so is the work
+    // done per call. When the table is full new boards are simply not recorded: the search
+    // stays exact and only re-expands more. Boards must pass isPackable().
+    class FixedSolver {
+    public:
+        // Block size for `p` with room for `tableEntries` table slots.
+        static size_t requiredBytes(const Params& p, int maxDepth, size_t tableEntries);
+
+        FixedSolver(void* memory, size_t bytes, const Params& p, FixedSolveOptions o = {});
+
+        // False when the block cannot hold the board arrays plus a minimal table.
+        bool ready() const { return tableBuckets > 0; }
+
+        // Fills `out` like Solver::solve (one optimal path, distinctSolutions == 1, no counting).
+        // Allocation-free when out.solutionMoves already has capacity for maxDepth moves.
+        // Returns false, with `reason`, for boards this solver cannot take.
+        bool solve(const State& start, SolveResult& out, std::string* reason = nullptr);
+        SolveResult solve(const State& start);
+
+        const FixedSolveStats& stats() const { return lastStats; }
+
+    private:
+        struct Step { uint8_t from{ 0 }; uint8_t to{ 0 }; uint8_t amount{ 0 }; };
+        struct TableEntry { uint32_t check{ 0 }; uint16_t iteration{ 0 }; uint8_t g{ 0 }; uint8_t used{ 0 }; };
+
+        bool seenAtOrAbove(int g);
+
+        Params params;
+        FixedSolveOptions opt;
+        PackedBatch board;
+        Step* path{ nullptr };
+        uint16_t* cursor{ nullptr };
+        uint8_t* amounts{ nullptr };
+        TableEntry* table{ nullptr };
+        size_t tableBuckets{ 0 };   // power of two, two entries each
+        uint16_t iteration{ 0 };
+        FixedSolveStats lastStats;
+    };
+
+} // namespace ws
@@ -1,13 +1,37 @@
 ﻿// ========================= src/core/Generator.cpp =========================
 #include "Generator.hpp"
 #include "Solver.hpp"
+#include "PathImprover.hpp"
 #include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <limits>
 #include <numeric>
 
 namespace ws {
 
-    Generator::Generator(Params p_, GenOptions opt_) :p(p_), opt(opt_) { rng.s = opt.seed ? opt.seed : 0xBADC0FFEEULL; }
+    uint64_t dedupFingerprint(const State& s) {
+        uint64_t key = s.canonicalHash();
+        if (s.p.ruleSet != RuleSetId::Classic) key ^= 0x9E3779B97F4A7C15ull * (uint64_t)s.p.ruleSet;
+        return key;
+    }
+
+    bool CandidateIndex::claim(uint64_t key) {
+        Shard& sh = shards[(key >> 58) % kShards];
+        std::lock_guard<std::mutex> lock(sh.m);
+        return sh.keys.insert(key).second;
+    }
+
+    size_t CandidateIndex::size() const {
+        size_t n = 0;
+        for (const auto& sh : shards) {
+            std::lock_guard<std::mutex> lock(sh.m);
+            n += sh.keys.size();
+        }
+        return n;
+    }
+
+    Generator::Generator(Params p_, GenOptions opt_) :p(p_), opt(opt_) { rng = RNG::forStream(opt.seed ? opt.seed : 0xBADC0FFEEULL, opt.stream); }
 
     void Generator::setBase(const State& b) { base = b; }
 
@@ -42,10 +66,7 @@ namespace ws {
         for (Color c = 1; c <= p.numColors; ++c) {
             for (int k = 0; k < p.capacity; ++k) bag.push_back(c);
         }
-        for (size_t i = 0; i < bag.size(); ++i) {
-            size_t j = (size_t)rng.irange((int)i, (int)bag.size() - 1);
-            std::swap(bag[i], bag[j]);
-        }
+        rng.shuffle(bag);
 
         State tpl; tpl.p = p; tpl.B.resize(p.numBottles);
         size_t pos = 0;
@@ -89,10 +110,7 @@ namespace ws {
             std::iota(order.begin(), order.end(), 0);
 
             auto shuffleOrder = [&]() {
-                for (size_t i = 0; i < order.size(); ++i) {
-                    size_t j = (size_t)rng.irange((int)i, (int)order.size() - 1);
-                    std::swap(order[i], order[j]);
-                }
+                rng.shuffle(order);
                 };
 
             auto pickEligible = [&](auto&& pred) -> int {
@@ -197,10 +215,7 @@ namespace ws {
                 ", allowed " + std::to_string(totalQuestionCapacity) + ").");
             return std::nullopt;
         }
-        for (size_t i = 0; i < hideCandidates.size(); ++i) {
-            size_t j = (size_t)rng.irange((int)i, (int)hideCandidates.size() - 1);
-            std::swap(hideCandidates[i], hideCandidates[j]);
-        }
+        rng.shuffle(hideCandidates);
         for (int i = 0; i < questionCount; ++i) {
             auto [bi, si] = hideCandidates[i];
             tpl.B[bi].slots[si].hidden = true;
@@ -274,17 +289,80 @@ namespace ws {
         return true;
     }
 
-    void Generator::scramble(State& s, int& outMix, std::vector<Move>* outSteps) {
+    void MixMetrics::reset(const State& s) {
+        const size_t n = s.B.size();
+        breaks.assign(n, 0);
+        entropy.assign(n, 0.0);
+        heuristic.assign(n, 0);
+        height.assign(n, 0);
+        breakSum = heuristicSum = nonEmpty = 0;
+        empty = (int)n;
+        entropySum = 0.0;
+        int cells = 0;
+        for (size_t i = 0; i < n; ++i) {
+            cells += s.B[i].size();
+            update(s, (int)i);
+        }
+        // Neighbouring cells of a random deal differ with chance 1 - 1/colours; the goal board
+        // has about one bottle per colour, so roughly cells - colours neighbour pairs.
+        const int colours = std::max(1, s.p.numColors);
+        randomBreaks = std::max(1.0, (cells - colours) * (1.0 - 1.0 / colours));
+    }
+
+    void MixMetrics::update(const State& s, int bottle) {
+        const auto& b = s.B[bottle];
+        int br = 0;
+        std::array<int, 21> counts{};
+        for (int k = 0; k < b.size(); ++k) {
+            if (k > 0 && b.slots[k].c != b.slots[k - 1].c) ++br;
+            ++counts[std::min<int>(b.slots[k].c, 20)];
+        }
+        double bits = 0.0;
+        for (int c : counts) {
+            if (c == 0) continue;
+            const double q = (double)c / b.size();
+            bits -= q * std::log2(q);
+        }
+        const int h = Solver::heuristicTerm(b);
+        const int filledBefore = height[bottle] > 0 ? 1 : 0;
+        const int filledAfter = b.size() > 0 ? 1 : 0;
+        nonEmpty += filledAfter - filledBefore;
+        empty -= filledAfter - filledBefore;
+        breakSum += br - breaks[bottle];
+        entropySum += bits - entropy[bottle];
+        heuristicSum += h - heuristic[bottle];
+        breaks[bottle] = br;
+        entropy[bottle] = bits;
+        heuristic[bottle] = h;
+        height[bottle] = b.size();
+    }
+
+    int MixMetrics::solverHeuristic() const {
+        return std::max(0, heuristicSum - std::min(2, empty));
+    }
+
+    bool Generator::mixedEnough(const MixMetrics& m) const {
+        if (m.level() < opt.mixTarget) return false;
+        if (opt.mixEntropyTarget > 0.0 && m.meanEntropy() < opt.mixEntropyTarget) return false;
+        return opt.mixHeuristicTarget <= 0 || m.solverHeuristic() >= opt.mixHeuristicTarget;
+    }
+
+    bool Generator::scramble(State& s, int& outMix, std::vector<Move>* outSteps) {
         // Reverse‑move scramble from goal‑like state.
         // Generation-only rule:
         //  - pick a random amount from source bottle (1..source size)
         //  - allow moving to empty bottle or any bottle with enough free cells
         //  - ignore destination top color mismatch
-        int target = rng.irange(opt.mixMin, opt.mixMax);
+        // Adaptive: the mix targets decide where to stop, so no step count is drawn; mixMax only
+        // caps how long an unmixed board is scrambled.
+        const int target = opt.adaptiveScramble ? std::min(10000, 2 * opt.mixMax) : rng.irange(opt.mixMin, opt.mixMax);
         outMix = 0;
         Move last{ -1,-1,0 };
         if (outSteps) outSteps->clear();
+        MixMetrics metrics;
+        if (opt.adaptiveScramble) metrics.reset(s);
         for (int step = 0; step < target; ++step) {
+            if (opt.adaptiveScramble && step >= opt.mixMin && mixedEnough(metrics)) return true;
             std::vector<Move> mv;
             for (int i = 0; i < (int)s.B.size(); ++i) {
                 const auto& from = s.B[i];
@@ -301,11 +379,16 @@ namespace ws {
                 }
             }
             if (mv.empty()) break;
-            auto m = mv[rng.irange(0, (int)mv.size() - 1)];
+            auto m = mv[rng.below((uint32_t)mv.size())];
             s.apply(m);
+            if (opt.adaptiveScramble) {
+                metrics.update(s, m.from);
+                metrics.update(s, m.to);
+            }
             if (outSteps) outSteps->push_back(m);
             last = m; ++outMix;
         }
+        return !opt.adaptiveScramble || mixedEnough(metrics);
     }
 
     bool Generator::placeGimmicksRespecting(const State& sIn, State& out) {
@@ -324,6 +407,8 @@ namespace ws {
         int failedApplyTemplate = 0;
         int failedNoMove = 0;
         int failedSolver = 0;
+        int failedDuplicate = 0;
+        int failedOrdered = 0;
         for (int tries = 0; tries < opt.gimmickPlacementTries; ++tries) {
             State s = createStartFromInitial(initial);
             State scrambleStart;
@@ -333,7 +418,10 @@ namespace ws {
             // startMixed OFF: 정렬 시작점에서 scramble 과정을 기록한 뒤 solve
             if (!opt.startMixed) {
                 scrambleStart = s;
-                scramble(s, mix, &scrambleMoves);
+                if (!scramble(s, mix, &scrambleMoves)) {
+                    ++failedOrdered;
+                    continue;
+                }
                 applyTemplateHiddenAfterScramble(s);
                 if (!applyTemplateGimmicksAfterScramble(s)) {
                     ++failedApplyTemplate;
@@ -347,15 +435,50 @@ namespace ws {
                 scrambleStart = State{}; // scramble playback 비활성화를 명시
             }
 
+            // The layout is claimed before any solving; one that failed to solve stays claimed,
+            // since the same layout would fail again under the same budget.
+            if (dedup && !dedup->claim(dedupFingerprint(s))) {
+                ++failedDuplicate;
+                ++skippedDuplicates;
+                continue;
+            }
+
             if (!hasAnyMove(s)) {
                 ++failedNoMove;
                 continue;
                 
             }
-            Solver solver(opt.solveTimeMs);
+            Solver solver(opt.solveTimeMs, opt.countWorkers, opt.solveWeight);
+            solver.setMoveOrder(opt.moveOrder.get());
+            const auto solveStart = std::chrono::steady_clock::now();
             auto res = solver.solve(s);
+            const uint64_t attempt = solvesRun++;
+            if (slowSink) {
+                const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - solveStart).count();
+                if (!res.solved || res.timedOut || ms >= slowThresholdMs) {
+                    SlowAttempt a;
+                    a.state = s;
+                    a.seed = opt.seed;
+                    a.stream = opt.stream;
+                    a.attempt = attempt;
+                    a.solveTimeMs = opt.solveTimeMs;
+                    a.solveWeight = opt.solveWeight;
+                    a.countWorkers = opt.countWorkers;
+                    a.moveOrder = opt.moveOrder != nullptr;
+                    a.elapsedMs = ms;
+                    a.solved = res.solved;
+                    a.timedOut = res.timedOut;
+                    a.minMoves = res.minMoves;
+                    a.lowerBound = res.lowerBound;
+                    slowSink(a);
+                }
+            }
             if (res.solved) {
                 Generated g; g.state = s; g.scrambleStart = scrambleStart; g.mixCount = mix; g.minMoves = res.minMoves;
+                if (res.lowerBound < res.minMoves) {
+                    g.minMovesExact = false;
+                    g.minMovesLowerBound = res.lowerBound;
+                }
                 g.diffScore = solver.estimateDifficulty(s, res);
                 g.diffLabel = labelForScore(g.diffScore);
                 g.scrambleMoves = std::move(scrambleMoves);
@@ -363,6 +486,26 @@ namespace ws {
                 g.difficulty = res.difficulty;
                 return g;
             }
+            if (res.timedOut && opt.improveOnTimeout) {
+                ImproveOptions io;
+                io.timeBudgetMs = opt.improveTimeMs;
+                io.lowerBound = std::max(0, res.lowerBound);
+                io.moveOrder = opt.moveOrder.get();
+                auto improved = PathImprover(io).improve(s);
+                if (improved.found) {
+                    // Score with the improved length; an unproven count earns no solution bonus.
+                    res.minMoves = improved.bestLength;
+                    Generated g; g.state = s; g.scrambleStart = scrambleStart; g.mixCount = mix; g.minMoves = improved.bestLength;
+                    g.minMovesExact = improved.gap == 0;
+                    g.minMovesLowerBound = improved.lowerBound;
+                    g.diffScore = solver.estimateDifficulty(s, res);
+                    g.diffLabel = labelForScore(g.diffScore);
+                    g.scrambleMoves = std::move(scrambleMoves);
+                    g.solutionMoves = std::move(improved.path);
+                    g.difficulty = res.difficulty;
+                    return g;
+                }
+            }
             ++failedSolver;
             // 실패 시 다음 시도
         }
@@ -376,6 +519,12 @@ namespace ws {
         else if (failedApplyTemplate > 0) {
             setReason("Template gimmick constraints became invalid after scramble.");
         }
+        else if (failedDuplicate > 0) {
+            setReason("Every candidate duplicated a map that was already generated.");
+        }
+        else if (failedOrdered > 0) {
+            setReason("Scramble stayed too ordered to reach the mix target.");
+        }
         else {
             setReason("Generator exhausted retry budget before producing a valid map.");
         }
@@ -431,10 +580,7 @@ namespace ws {
             }
             if (indices.empty()) continue;
 
-            for (size_t i = 0; i < indices.size(); ++i) {
-                size_t j = (size_t)rng.irange((int)i, (int)indices.size() - 1);
-                std::swap(indices[i], indices[j]);
-            }
+            rng.shuffle(indices);
 
             int requested = (bi < perBottleRequested.size()) ? perBottleRequested[bi] : 0;
             int take = std::min(requested, (int)indices.size());
@@ -451,10 +597,7 @@ namespace ws {
         int remain = totalRequested - placed;
         if (remain <= 0 || leftovers.empty()) return;
 
-        for (size_t i = 0; i < leftovers.size(); ++i) {
-            size_t j = (size_t)rng.irange((int)i, (int)leftovers.size() - 1);
-            std::swap(leftovers[i], leftovers[j]);
-        }
+        rng.shuffle(leftovers);
         int extra = std::min(remain, (int)leftovers.size());
         for (int i = 0; i < extra; ++i) {
             auto [bi, si] = leftovers[i];
@@ -550,10 +693,7 @@ namespace ws {
 
         std::vector<int> order(p.numBottles);
         std::iota(order.begin(), order.end(), 0);
-        for (size_t i = 0; i < order.size(); ++i) {
-            size_t j = (size_t)rng.irange((int)i, (int)order.size() - 1);
-            std::swap(order[i], order[j]);
-        }
+        rng.shuffle(order);
 
         int remaining = (int)totalCells;
         for (int idx = 0; idx < active; ++idx) {
@@ -708,10 +848,7 @@ namespace ws {
                 for (int k = 0; k < remaining[c]; ++k) bag.push_back(c);
             }
 
-            for (size_t i = 0; i < bag.size(); ++i) {
-                size_t j = size_t(rng.irange(0, bag.empty() ? 0 : (int)bag.size() - 1));
-                std::swap(bag[i], bag[j]);
-            }
+            rng.shuffle(bag);
 
             auto runlen = [](const Bottle& b, Color c) {
                 int len = 0; for (int i = (int)b.slots.size() - 1; i >= 0; --i) { if (b.slots[i].c == c) ++len; else break; }
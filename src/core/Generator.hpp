@@ -1,8 +1,14 @@
 // ========================= src/core/Generator.hpp =========================
 #pragma once
 #include "Solver.hpp"
+#include "MoveOrder.hpp"
+#include <array>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <unordered_set>
 
 namespace ws {
 
@@ -10,6 +16,7 @@ namespace ws {
         int mixMin{ 60 };
         int mixMax{ 180 };
         uint64_t seed{ 0xA17C3B5ECAFEBEEFULL };
+        uint32_t stream{ 0 };      // parallel worker index: RNG stream jumped 2^128 draws per step
         int gimmickPlacementTries{ 30 };
         int solveTimeMs{ 2500 }; // validation solver budget per attempt
 
@@ -18,6 +25,29 @@ namespace ws {
         int  reservedEmpty{ 2 };      // 초기 상태에서 비워둘 병 개수(일반적으로 2)
         int  maxRunPerBottle{ 2 };    // 한 병 안에서 같은 색이 연속으로 허용되는 최대 길이(섞임 유지)
         bool randomizeHeights{ true }; // 랜덤 높이 배분 사용 여부 (auto template)
+
+        // Adaptive scramble (startMixed off): after mixMin steps, stop as soon as the board meets
+        // every mix target below, whatever the step count; no count between mixMin and mixMax is
+        // drawn, and a board still unmixed after twice mixMax steps is dropped before the solver runs.
+        bool adaptiveScramble{ false };
+        double mixTarget{ 0.85 };       // colour breaks relative to a random deal (MixMetrics::level)
+        double mixEntropyTarget{ 0.0 }; // mean bits per non-empty bottle; 0 = unused
+        int mixHeuristicTarget{ 0 };    // solver heuristic at least this; 0 = unused
+
+        // Solver time-outs: accept the map with a shortened feasible path instead of rejecting it.
+        bool improveOnTimeout{ false };
+        int improveTimeMs{ 3000 };
+
+        // Threads for the optimal-solution count after each successful solve (see Solver).
+        int countWorkers{ 1 };
+
+        // Above 1: solve with weighted A* and accept maps whose minMoves is proven within this
+        // factor of optimal (stored as an upper bound with its lower bound).
+        double solveWeight{ 1.0 };
+
+        // Learned child ordering for the validation solver and the timeout improver; shared so
+        // copies of the options handed to worker threads keep it alive.
+        std::shared_ptr<const MoveOrderModel> moveOrder;
     };
 
     struct Generated {
@@ -25,6 +55,8 @@ namespace ws {
         State scrambleStart;
         int mixCount{ 0 };
         int minMoves{ -1 };
+        bool minMovesExact{ true };    // false when minMoves is a found path not proven optimal
+        int minMovesLowerBound{ -1 };  // proven lower bound when minMovesExact is false
         double diffScore{ 0.0 };
         std::string diffLabel;
         std::vector<Move> scrambleMoves;
@@ -32,10 +64,70 @@ namespace ws {
         SolveResult::DifficultyBreakdown difficulty;
     };
 
+    // How mixed a scramble is, kept per bottle so a pour refreshes only its two bottles.
+    struct MixMetrics {
+        std::vector<int> breaks;        // adjacent cells of different colours
+        std::vector<double> entropy;    // bits of the bottle's colour distribution
+        std::vector<int> heuristic;     // Solver::heuristicTerm
+        std::vector<int> height;
+        int breakSum{ 0 };
+        double entropySum{ 0.0 };
+        int heuristicSum{ 0 };
+        int nonEmpty{ 0 };
+        int empty{ 0 };
+        double randomBreaks{ 1.0 };     // expected breaks of a uniformly random deal of the same cells
+
+        void reset(const State& s);
+        void update(const State& s, int bottle);
+        double level() const { return breakSum / randomBreaks; }
+        double meanEntropy() const { return nonEmpty > 0 ? entropySum / nonEmpty : 0.0; }
+        int solverHeuristic() const;    // Solver's heuristic for the same board
+    };
+
     // If initialDistribution is provided, it overrides the default goal distribution.
     // The counts MUST sum to numColors*capacity, and each bottle vector has bottom->top colors (0 means empty cell at bottom is not stored; provide exact heights).
     using InitialDistribution = std::vector<std::vector<Color>>; // size=bottles, each is a stack bottom->top
 
+    // Canonical layout key used for dedup: State::canonicalHash, plus the rule set for
+    // non-Classic maps, so bottle order does not matter and rule variants stay distinct.
+    uint64_t dedupFingerprint(const State& s);
+
+    // Fingerprints shared by parallel generators. claim() is atomic per key, so exactly one
+    // worker wins each layout.
+    class CandidateIndex {
+    public:
+        bool claim(uint64_t key);   // false when the key was already claimed
+        size_t size() const;
+
+    private:
+        static constexpr size_t kShards = 64;
+        struct Shard {
+            mutable std::mutex m;
+            std::unordered_set<uint64_t> keys;
+        };
+        std::array<Shard, kShards> shards;
+    };
+
+    // A solver input from makeOne that failed, timed out or ran past the capture threshold, with
+    // enough context to replay it: the candidate exactly as handed to Solver::solve, the options
+    // that shaped the solve and what the solve reported.
+    struct SlowAttempt {
+        State state;
+        uint64_t seed{ 0 };
+        uint32_t stream{ 0 };
+        uint64_t attempt{ 0 };         // solves run by this generator before this one
+        int solveTimeMs{ 0 };
+        double solveWeight{ 1.0 };
+        int countWorkers{ 1 };
+        bool moveOrder{ false };       // a learned move-order model was set
+        double elapsedMs{ 0.0 };
+        bool solved{ false };
+        bool timedOut{ false };
+        int minMoves{ -1 };
+        int lowerBound{ -1 };
+    };
+    using SlowAttemptSink = std::function<void(const SlowAttempt&)>;
+
     class Generator {
     public:
         Generator(Params p, GenOptions opt);
@@ -50,11 +142,27 @@ namespace ws {
         // Attach current base state (with bottle gimmicks already set from UI). If not set, defaults used.
         void setBase(const State& base);
 
+        // Optional shared index checked in makeOne before the solver runs: a candidate whose
+        // layout is already claimed is dropped as a duplicate and the next try starts.
+        void setDedupIndex(CandidateIndex* index) { dedup = index; }
+        int duplicatesSkipped() const { return skippedDuplicates; }
+
+        // Optional hook called on the generating thread for every makeOne solve that does not
+        // solve, times out or takes at least `thresholdMs`.
+        void setSlowAttemptSink(SlowAttemptSink sink, double thresholdMs) { slowSink = std::move(sink); slowThresholdMs = thresholdMs; }
+
     private:
         Params p; GenOptions opt; RNG rng; std::optional<State> base;
+        CandidateIndex* dedup{ nullptr };
+        int skippedDuplicates{ 0 };
+        SlowAttemptSink slowSink;
+        double slowThresholdMs{ 0.0 };
+        uint64_t solvesRun{ 0 };
 
         State createStartFromInitial(const InitialDistribution* initial);
-        void scramble(State& s, int& outMix, std::vector<Move>* outSteps = nullptr);
+        // False when an adaptive scramble ran out of steps before reaching the mix targets.
+        bool scramble(State& s, int& outMix, std::vector<Move>* outSteps = nullptr);
+        bool mixedEnough(const MixMetrics& m) const;
         bool canPourForGeneration(const State& s, int from, int to, int amount) const;
         bool placeGimmicksRespecting(const State& sIn, State& out);
         State createRandomMixed();  // NEW
@@ -0,0 +1,182 @@
+// ========================= src/core/HintTable.cpp =========================
+#include "HintTable.hpp"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <unordered_set>
+
+namespace ws {
+
+    const HintEntry* HintTable::find(uint64_t fingerprint) const {
+        auto it = std::lower_bound(entries.begin(), entries.end(), fingerprint,
+            [](const HintEntry& e, uint64_t fp) { return e.fingerprint < fp; });
+        if (it == entries.end() || it->fingerprint != fingerprint) return nullptr;
+        return &*it;
+    }
+
+    const DistanceOracle::Known* DistanceOracle::lookup(uint64_t fingerprint) const {
+        auto it = cache.find(fingerprint);
+        return it == cache.end() ? nullptr : &it->second;
+    }
+
+    std::optional<DistanceOracle::Known> DistanceOracle::solve(const State& input, uint64_t nodeLimit, const std::function<bool()>& timeOk) {
+        const State root = Solver::normalizeForSolve(input);
+        const uint64_t rootKey = root.fingerprint();
+        if (auto it = cache.find(rootKey); it != cache.end()) return it->second;
+        if (root.isSolved()) {
+            cache[rootKey] = Known{ 0, Move{} };
+            return cache[rootKey];
+        }
+
+        constexpr int kInf = std::numeric_limits<int>::max();
+        std::unordered_map<uint64_t, int> seen; // shallowest depth expanded in this iteration
+        std::vector<Move> path;
+        std::vector<uint64_t> keys;             // fingerprint after each move of `path`
+        uint64_t nodes = 0;
+        bool stopped = false;
+        int total = -1;
+
+        std::function<int(const State&, uint64_t, int, int)> dfs = [&](const State& s, uint64_t key, int g, int bound) {
+            if (s.isSolved()) { total = g; return -1; }
+            if (g > 0) {
+                if (auto it = cache.find(key); it != cache.end()) {
+                    if (it->second.distance < 0) return kInf;
+                    const int f = g + it->second.distance;
+                    if (f <= bound) { total = f; return -1; }
+                    return f;
+                }
+            }
+            const int f = g + Solver::runLowerBound(s);
+            if (f > bound) return f;
+
+            auto [it, fresh] = seen.try_emplace(key, g);
+            if (!fresh) {
+                if (it->second <= g) return kInf;
+                it->second = g;
+            }
+            if (++nodes > nodeLimit || ((nodes & 255) == 0 && !timeOk())) { stopped = true; return kInf; }
+
+            int minNext = kInf;
+            for (int i = 0; i < (int)s.B.size(); ++i) {
+                for (int j = 0; j < (int)s.B.size(); ++j) {
+                    int amt = 0;
+                    if (i == j || !s.canPour(i, j, &amt)) continue;
+                    State child = s;
+                    Move m{ i,j,amt };
+                    child.apply(m);
+                    const uint64_t childKey = child.fingerprint();
+                    path.push_back(m);
+                    keys.push_back(childKey);
+                    const int t = dfs(child, childKey, g + 1, bound);
+                    if (t == -1) return -1;
+                    path.pop_back();
+                    keys.pop_back();
+                    if (stopped) return kInf;
+                    minNext = std::min(minNext, t);
+                }
+            }
+            return minNext;
+        };
+
+        int bound = std::max(1, Solver::runLowerBound(root));
+        while (true) {
+            seen.clear();
+            const int t = dfs(root, rootKey, 0, bound);
+            if (t == -1) break;
+            if (stopped) return std::nullopt;
+            if (t == kInf) {
+                // Nothing exceeded the bound and nothing solved: every reachable board is a dead end.
+                cache[rootKey] = Known{ -1, Move{} };
+                return cache[rootKey];
+            }
+            bound = t;
+        }
+
+        // Every suffix of an optimal line is optimal, so each board on it is cached as well.
+        cache[rootKey] = Known{ total, path[0] };
+        for (size_t i = 1; i < path.size(); ++i) cache.emplace(keys[i - 1], Known{ total - (int)i, path[i] });
+        if (total == (int)path.size()) cache.emplace(keys.back(), Known{ 0, Move{} });
+        return cache[rootKey];
+    }
+
+    std::optional<HintTable> buildHintTable(const State& start, const HintOptions& opt, std::string* reason) {
+        using clock = std::chrono::steady_clock;
+        auto t0 = clock::now();
+        std::function<bool()> timeOk = [&] {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - t0).count() < opt.timeBudgetMs;
+        };
+        auto fail = [&](const char* why) -> std::optional<HintTable> {
+            if (reason) *reason = why;
+            return std::nullopt;
+        };
+
+        const State s0 = Solver::normalizeForSolve(start);
+        DistanceOracle oracle;
+        auto rootKnown = oracle.solve(s0, std::numeric_limits<uint64_t>::max(), timeOk);
+        if (!rootKnown) return fail("Start board was not solved within the time budget.");
+        if (rootKnown->distance < 0) return fail("Start board is unsolvable.");
+        if (rootKnown->distance >= HintEntry::kDeadEnd) return fail("Optimal solution too long for the hint format.");
+
+        HintTable table;
+        table.optimalMoves = rootKnown->distance;
+        table.complete = true;
+
+        auto addEntry = [&](uint64_t fp, const DistanceOracle::Known& k) {
+            HintEntry e;
+            e.fingerprint = fp;
+            if (k.distance >= 0) {
+                if (k.distance >= HintEntry::kDeadEnd) { table.complete = false; return; }
+                e.from = (uint8_t)k.next.from;
+                e.to = (uint8_t)k.next.to;
+                e.amount = (uint8_t)k.next.amount;
+                e.distance = (uint8_t)k.distance;
+            }
+            table.entries.push_back(e);
+        };
+
+        // Layer 0 is the optimal line itself; layer r holds boards r moves off it.
+        std::unordered_set<uint64_t> covered;
+        std::vector<State> layer;
+        {
+            State s = s0;
+            while (true) {
+                const uint64_t fp = s.fingerprint();
+                if (!covered.insert(fp).second) break;
+                layer.push_back(s);
+                const auto* k = oracle.lookup(fp);
+                if (!k || k->distance <= 0) break;
+                s.apply(k->next);
+            }
+        }
+
+        for (int r = 0; r <= std::max(0, opt.radius) && !layer.empty(); ++r) {
+            std::vector<State> next;
+            for (const auto& s : layer) {
+                if (!timeOk() || table.entries.size() >= opt.maxEntries) { table.complete = false; break; }
+                const uint64_t fp = s.fingerprint();
+                if (!s.isSolved()) {
+                    auto known = oracle.solve(s, opt.nodesPerBoard, timeOk);
+                    if (known) addEntry(fp, *known);
+                    else table.complete = false;
+                }
+                if (r == opt.radius) continue;
+                for (int i = 0; i < (int)s.B.size(); ++i) {
+                    for (int j = 0; j < (int)s.B.size(); ++j) {
+                        int amt = 0;
+                        if (i == j || !s.canPour(i, j, &amt)) continue;
+                        State child = s;
+                        child.apply(Move{ i,j,amt });
+                        if (covered.insert(child.fingerprint()).second) next.push_back(std::move(child));
+                    }
+                }
+            }
+            if (!table.complete && (!timeOk() || table.entries.size() >= opt.maxEntries)) break;
+            layer.swap(next);
+        }
+
+        std::sort(table.entries.begin(), table.entries.end(),
+            [](const HintEntry& a, const HintEntry& b) { return a.fingerprint < b.fingerprint; });
+        return table;
+    }
+
+} // namespace ws
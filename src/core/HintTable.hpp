@@ -0,0 +1,59 @@
+// ========================= src/core/HintTable.hpp =========================
+#pragma once
+#include "Solver.hpp"
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace ws {
+
+    // One precomputed hint: for the board with this State::fingerprint(), the next move of an
+    // optimal solution and the exact number of moves left. Dead ends use kNoMove / kDeadEnd.
+    struct HintEntry {
+        static constexpr uint8_t kNoMove = 0xFF;
+        static constexpr uint8_t kDeadEnd = 0xFF;
+
+        uint64_t fingerprint{ 0 };
+        uint8_t from{ kNoMove };
+        uint8_t to{ kNoMove };
+        uint8_t amount{ 0 };
+        uint8_t distance{ kDeadEnd };
+    };
+
+    struct HintOptions {
+        int radius{ 2 };              // cover boards up to this many moves off the optimal line
+        int timeBudgetMs{ 20000 };    // per map
+        uint64_t nodesPerBoard{ 200000 }; // exact-distance search cap for a single off-line board
+        size_t maxEntries{ 200000 };
+    };
+
+    // Hints for one map, sorted by fingerprint for binary-search lookup.
+    struct HintTable {
+        int optimalMoves{ -1 };
+        bool complete{ false };       // every board within the radius got an entry
+        std::vector<HintEntry> entries;
+
+        const HintEntry* find(uint64_t fingerprint) const;
+    };
+
+    // Exact distance to a solved board. IDA* on Solver::runLowerBound where boards already in the
+    // cache count as leaves with their known distance, so once the optimal line is cached, boards
+    // near it resolve in a handful of nodes. One oracle is meant to be shared by all boards of a map.
+    class DistanceOracle {
+    public:
+        struct Known { int distance{ -1 }; Move next{}; }; // distance -1: proven dead end
+
+        // Exact distance of `s` (revealed with Solver::normalizeForSolve) and the first move of an
+        // optimal line, or nullopt when the node cap or `timeOk` stopped the search.
+        std::optional<Known> solve(const State& s, uint64_t nodeLimit, const std::function<bool()>& timeOk);
+
+        const Known* lookup(uint64_t fingerprint) const;
+        size_t cacheSize() const { return cache.size(); }
+
+    private:
+        std::unordered_map<uint64_t, Known> cache;
+    };
+
+    std::optional<HintTable> buildHintTable(const State& start, const HintOptions& opt = {}, std::string* reason = nullptr);
+
+} // namespace ws
@@ -0,0 +1,132 @@
+// ========================= src/core/LibraryStats.cpp =========================
+#include "LibraryStats.hpp"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace ws {
+
+    int QuantileSketch::capacity(int level) const {
+        const int depth = (int)levels.size() - 1 - level;
+        return std::max(2, (int)std::ceil(k * std::pow(2.0 / 3.0, depth)));
+    }
+
+    void QuantileSketch::add(double v) {
+        if (n == 0) lo = hi = v;
+        lo = std::min(lo, v);
+        hi = std::max(hi, v);
+        ++n;
+        if (levels.empty()) levels.emplace_back();
+        levels[0].push_back(v);
+        compress();
+    }
+
+    void QuantileSketch::compress() {
+        size_t total = 0, limit = 0;
+        for (int h = 0; h < (int)levels.size(); ++h) {
+            total += levels[h].size();
+            limit += (size_t)capacity(h);
+        }
+        if (total < limit) return;
+        for (int h = 0; h < (int)levels.size(); ++h) {
+            if ((int)levels[h].size() < capacity(h)) continue;
+            if (h + 1 == (int)levels.size()) levels.emplace_back();
+            auto& cur = levels[h];
+            std::sort(cur.begin(), cur.end());
+            // An odd item out stays behind so weights stay exact.
+            const size_t pairs = cur.size() / 2;
+            const size_t keepFrom = pairs * 2;
+            auto& up = levels[h + 1];
+            for (size_t i = flip ? 1 : 0; i < keepFrom; i += 2) up.push_back(cur[i]);
+            flip = !flip;
+            cur.erase(cur.begin(), cur.begin() + (long)keepFrom);
+            break;
+        }
+    }
+
+    double QuantileSketch::quantile(double q) const {
+        if (n == 0) return 0.0;
+        if (q <= 0.0) return lo;
+        if (q >= 1.0) return hi;
+        std::vector<std::pair<double, uint64_t>> items;
+        for (size_t h = 0; h < levels.size(); ++h) {
+            for (double v : levels[h]) items.emplace_back(v, uint64_t(1) << h);
+        }
+        std::sort(items.begin(), items.end());
+        uint64_t total = 0;
+        for (const auto& it : items) total += it.second;
+        const double target = q * (double)total;
+        uint64_t seen = 0;
+        for (const auto& it : items) {
+            seen += it.second;
+            if ((double)seen >= target) return it.first;
+        }
+        return hi;
+    }
+
+    void QuantileSketch::clear() {
+        n = 0;
+        lo = hi = 0.0;
+        flip = false;
+        levels.clear();
+    }
+
+    const char* const LibraryStats::kLabelNames[kLabelCount] = { "Very Easy", "Easy", "Normal", "Hard", "Very Hard", "Other" };
+
+    int LibraryStats::scoreBin(double s) {
+        return std::clamp((int)std::floor(s / (100.0 / kScoreBins)), 0, kScoreBins - 1);
+    }
+
+    int LibraryStats::movesBin(int moves) {
+        return std::clamp(moves / kMovesBinWidth, 0, kMovesBins - 1);
+    }
+
+    void LibraryStats::clear() {
+        *this = LibraryStats{};
+    }
+
+    void LibraryStats::add(const State& s, int moves, double difficultyScore, const std::string& difficultyLabel) {
+        int labelIdx = kLabelCount - 1;
+        const std::string& name = difficultyLabel.empty() ? labelForScore(difficultyScore) : difficultyLabel;
+        for (int i = 0; i < kLabelCount - 1; ++i) {
+            if (name == kLabelNames[i]) { labelIdx = i; break; }
+        }
+
+        size_t row = 0;
+        while (row < byParams.size()) {
+            const Params& p = byParams[row].params;
+            if (p.numColors == s.p.numColors && p.numBottles == s.p.numBottles && p.capacity == s.p.capacity && p.ruleSet == s.p.ruleSet) break;
+            ++row;
+        }
+        if (row == byParams.size()) byParams.push_back(ParamsRow{ s.p });
+        byParams[row].maps++;
+        byParams[row].labels[labelIdx]++;
+
+        int hidden = 0;
+        uint8_t mask = 0;
+        for (const auto& b : s.B) {
+            for (const auto& slot : b.slots) hidden += slot.hidden ? 1 : 0;
+            const int kind = (int)b.gimmick.kind;
+            if (kind > 0 && kind < 4) {
+                gimmickBottles[kind]++;
+                mask |= (uint8_t)(1u << (kind - 1));
+            }
+        }
+        for (int kind = 1; kind < 4; ++kind) {
+            if (mask & (1u << (kind - 1))) mapsWithGimmick[kind]++;
+        }
+        if (mask == 0) mapsWithGimmick[0]++;
+        hiddenHistogram[std::min(hidden, kMaxHidden)]++;
+
+        ++maps;
+        scoreSketch.add(difficultyScore);
+        scoreSum += difficultyScore;
+        if (moves >= 0) {
+            int& cell = joint[scoreBin(difficultyScore)][movesBin(moves)];
+            jointMax = std::max(jointMax, ++cell);
+            movesSketch.add(moves);
+            movesSum += moves;
+        }
+    }
+
+} // namespace ws
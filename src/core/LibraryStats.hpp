@@ -0,0 +1,72 @@
+// ========================= src/core/LibraryStats.hpp =========================
+#pragma once
+#include "Generator.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ws {
+
+    // KLL quantile sketch: about 3k stored items, rank error around 1.7/k. Compaction keeps every
+    // other item with an alternating offset, so results are deterministic for a given stream.
+    class QuantileSketch {
+    public:
+        QuantileSketch() = default;
+        explicit QuantileSketch(int k) : k(k) {}
+        void add(double v);
+        double quantile(double q) const;   // q in [0,1]; 0 when empty
+        uint64_t count() const { return n; }
+        double min() const { return lo; }
+        double max() const { return hi; }
+        void clear();
+
+    private:
+        int k{ 200 };
+        uint64_t n{ 0 };
+        double lo{ 0.0 }, hi{ 0.0 };
+        bool flip{ false };
+        std::vector<std::vector<double>> levels;   // level h items weigh 2^h
+
+        int capacity(int level) const;
+        void compress();
+    };
+
+    // Shape of a library, kept as aggregates that update in O(1) per added map, so it can follow
+    // a generation run live.
+    struct LibraryStats {
+        static constexpr int kScoreBins = 20;       // 5 points each over 0..100
+        static constexpr int kMovesBinWidth = 5;
+        static constexpr int kMovesBins = 16;       // last bin is open-ended (75+)
+        static constexpr int kLabelCount = 6;       // five bands in labelForScore order, then other
+        static constexpr int kMaxHidden = 24;       // last '?' histogram bin is open-ended
+        static const char* const kLabelNames[kLabelCount];
+
+        struct ParamsRow {
+            Params params;
+            int maps{ 0 };
+            std::array<int, kLabelCount> labels{};
+        };
+
+        size_t maps{ 0 };
+        std::array<std::array<int, kMovesBins>, kScoreBins> joint{};   // [score bin][moves bin], solved maps only
+        std::vector<ParamsRow> byParams;
+        std::array<int, 4> gimmickBottles{};    // by StackGimmickKind
+        std::array<int, 4> mapsWithGimmick{};
+        std::array<int, kMaxHidden + 1> hiddenHistogram{};
+        QuantileSketch scoreSketch;
+        QuantileSketch movesSketch;
+        double scoreSum{ 0.0 };
+        double movesSum{ 0.0 };
+        int jointMax{ 0 };
+
+        size_t size() const { return maps; }
+        void clear();
+        void add(const State& s, int moves, double difficultyScore, const std::string& difficultyLabel);
+        void add(const Generated& g) { add(g.state, g.minMoves, g.diffScore, g.diffLabel); }
+
+        static int scoreBin(double s);
+        static int movesBin(int moves);
+    };
+
+} // namespace ws
@@ -0,0 +1,182 @@
+// ========================= src/core/MoveOrder.cpp =========================
+#include "MoveOrder.hpp"
+#include "Solver.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <numeric>
+
+namespace ws {
+
+    namespace {
+
+        // Slice offsets of the weight table, one per feature.
+        constexpr int kShape = 0;        // 8: dest empty x source single-coloured x source emptied
+        constexpr int kAmount = 8;       // 8: cells poured
+        constexpr int kFinish = 16;      // 4: partial pour x dest completed
+        constexpr int kExposed = 20;     // 3: nothing exposed / exposed colour is an open top / other
+        constexpr int kRoom = 23;        // 8: dest room left
+        constexpr int kLeft = 31;        // 8: source height left
+        constexpr int kGimmicks = 39;    // 16: source gimmick x dest gimmick
+        constexpr int kLocks = 55;       // 3: no lock effect / releases a lock / breaks a full bottle
+        constexpr int kMixed = 58;       // 4: distinct colours in the source
+        constexpr int kDestRun = 62;     // 8: dest top run before the pour
+        static_assert(kDestRun + 8 == MoveOrderModel::kTableSize, "feature slices must fill the table");
+
+        int clamp7(int v) { return std::clamp(v, 0, 7); }
+
+        bool preferMove(const State& s, const Move& m) {
+            return !s.B[m.to].isEmpty() && s.B[m.from].topColor() == s.B[m.to].topColor();
+        }
+
+    } // namespace
+
+    MoveOrderModel::Context MoveOrderModel::context(const State& s) {
+        Context ctx;
+        std::array<bool, 21> completed{};
+        for (const auto& b : s.B) {
+            const Color t = b.topColor();
+            if (t >= 1 && t <= 20 && b.isMonoFull()) completed[t] = true;
+            if (t >= 1 && t <= 20 && b.size() < b.capacity) ctx.openTops |= 1u << t;
+        }
+        for (const auto& b : s.B) {
+            const Color t = b.gimmick.clothTarget;
+            if (b.gimmick.kind == StackGimmickKind::Cloth && t >= 1 && t <= 20 && !completed[t]) ctx.lockedClothTargets |= 1u << t;
+        }
+        return ctx;
+    }
+
+    MoveOrderModel::Features MoveOrderModel::features(const State& s, const Context& ctx, const Move& m) {
+        const Bottle& src = s.B[m.from];
+        const Bottle& dst = s.B[m.to];
+        const int run = src.topChunk();
+        const int amount = m.amount > 0 ? m.amount : run;
+        const Color colour = src.topColor();
+        const int left = src.size() - amount;
+
+        uint32_t seen = 0;
+        for (const auto& sl : src.slots) seen |= 1u << std::min<int>(sl.c, 31);
+        const int distinct = std::popcount(seen);
+
+        const bool destEmpty = dst.isEmpty();
+        const bool completes = dst.size() + amount == dst.capacity && (destEmpty ? amount == dst.capacity : dst.topChunk() == dst.size());
+        int exposed = 0;
+        if (left > 0) {
+            const Color under = src.slots[(size_t)left - 1].c;
+            exposed = (under == colour || (under <= 20 && ((ctx.openTops >> under) & 1u))) ? 1 : 2;
+        }
+        int lockEffect = 0;
+        if (completes) {
+            const bool cloth = colour <= 20 && ((ctx.lockedClothTargets >> colour) & 1u);
+            bool bush = false;
+            for (int n : { m.to - 1, m.to + 1 }) {
+                if (n < 0 || n >= (int)s.B.size() || s.B[n].gimmick.kind != StackGimmickKind::Bush) continue;
+                if ((size_t)n < s.locks.bushLocked.size() && s.locks.bushLocked[(size_t)n]) bush = true;
+            }
+            if (cloth || bush) lockEffect = 1;
+        }
+        if (lockEffect == 0 && src.isMonoFull()) lockEffect = 2;
+
+        Features f;
+        f[0] = (uint8_t)(kShape + (destEmpty ? 4 : 0) + (distinct == 1 ? 2 : 0) + (left == 0 ? 1 : 0));
+        f[1] = (uint8_t)(kAmount + clamp7(amount));
+        f[2] = (uint8_t)(kFinish + (amount < run ? 2 : 0) + (completes ? 1 : 0));
+        f[3] = (uint8_t)(kExposed + exposed);
+        f[4] = (uint8_t)(kRoom + clamp7(dst.capacity - dst.size() - amount));
+        f[5] = (uint8_t)(kLeft + clamp7(left));
+        f[6] = (uint8_t)(kGimmicks + std::clamp((int)src.gimmick.kind, 0, 3) * 4 + std::clamp((int)dst.gimmick.kind, 0, 3));
+        f[7] = (uint8_t)(kLocks + lockEffect);
+        f[8] = (uint8_t)(kMixed + std::clamp(distinct, 1, 4) - 1);
+        f[9] = (uint8_t)(kDestRun + clamp7(dst.topChunk()));
+        return f;
+    }
+
+    void MoveOrderTrainer::addSolution(const State& start, const std::vector<Move>& solution) {
+        State s = Solver::normalizeForSolve(start);
+        std::vector<Move> legal;
+        for (const auto& taken : solution) {
+            legal.clear();
+            int target = -1;
+            for (int i = 0; i < (int)s.B.size(); ++i) {
+                for (int j = 0; j < (int)s.B.size(); ++j) {
+                    int amt = 0;
+                    if (i == j || !s.canPour(i, j, &amt)) continue;
+                    if (i == taken.from && j == taken.to) target = (int)legal.size();
+                    legal.push_back(Move{ i, j, amt });
+                }
+            }
+            if (target < 0) return;     // the path no longer replays; keep what came before
+            if (legal.size() > 1 && legal.size() <= 0xFFFF) {
+                const auto ctx = MoveOrderModel::context(s);
+                Example e{ (uint32_t)candidates.size(), (uint16_t)legal.size(), (uint16_t)target, 0 };
+                const bool targetPreferred = preferMove(s, legal[(size_t)target]);
+                for (int k = 0; k < (int)legal.size(); ++k) {
+                    candidates.push_back(MoveOrderModel::features(s, ctx, legal[(size_t)k]));
+                    // Stable colour-match-first order, as the solver's fallback sorts.
+                    const bool pk = preferMove(s, legal[(size_t)k]);
+                    if ((pk && !targetPreferred) || (pk == targetPreferred && k < target)) ++e.baseline;
+                }
+                examplesList.push_back(e);
+            }
+            s.apply(legal[(size_t)target]);
+        }
+    }
+
+    MoveOrderModel MoveOrderTrainer::train(int epochs, float learningRate, MoveOrderTrainStats* stats) const {
+        MoveOrderModel model;
+        std::vector<uint32_t> order(examplesList.size());
+        std::iota(order.begin(), order.end(), 0u);
+        RNG rng(0x5EEDF00Dull);
+        std::vector<float> logits, grad(MoveOrderModel::kTableSize);
+
+        for (int epoch = 0; epoch < epochs; ++epoch) {
+            rng.shuffle(order);
+            const float lr = learningRate / (1.0f + 0.5f * (float)epoch);
+            for (uint32_t idx : order) {
+                const Example& e = examplesList[idx];
+                logits.resize(e.count);
+                float top = -1e30f;
+                for (int k = 0; k < e.count; ++k) {
+                    logits[(size_t)k] = model.score(candidates[e.first + (size_t)k]);
+                    top = std::max(top, logits[(size_t)k]);
+                }
+                float z = 0.0f;
+                for (float& l : logits) z += (l = std::exp(l - top));
+                // Cross-entropy gradient: probability minus one-hot, spread over each move's features.
+                std::fill(grad.begin(), grad.end(), 0.0f);
+                for (int k = 0; k < e.count; ++k) {
+                    const float g = logits[(size_t)k] / z - (k == e.target ? 1.0f : 0.0f);
+                    for (uint8_t f : candidates[e.first + (size_t)k]) grad[f] += g;
+                }
+                for (int w = 0; w < MoveOrderModel::kTableSize; ++w) model.weights[(size_t)w] -= lr * grad[(size_t)w];
+            }
+        }
+
+        if (stats) {
+            *stats = MoveOrderTrainStats{};
+            stats->examples = examplesList.size();
+            size_t hits = 0, baseHits = 0;
+            double rankSum = 0.0;
+            for (const auto& e : examplesList) {
+                const float mine = model.score(candidates[e.first + e.target]);
+                int rank = 0;
+                for (int k = 0; k < e.count; ++k) {
+                    const float other = model.score(candidates[e.first + (size_t)k]);
+                    if (other > mine || (other == mine && k < e.target)) ++rank;
+                }
+                stats->candidates += e.count;
+                hits += rank == 0 ? 1 : 0;
+                baseHits += e.baseline == 0 ? 1 : 0;
+                rankSum += rank;
+            }
+            if (!examplesList.empty()) {
+                const double n = (double)examplesList.size();
+                stats->topOne = hits / n;
+                stats->baselineTopOne = baseHits / n;
+                stats->meanRank = rankSum / n;
+            }
+        }
+        return model;
+    }
+
+} // namespace ws
@@ -0,0 +1,64 @@
+// ========================= src/core/MoveOrder.hpp =========================
+#pragma once
+#include "State.hpp"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace ws {
+
+    // Learned move ordering: a linear model over small categorical features of a pour. Every
+    // feature owns a slice of one weight table, so a move's score is kFeatureCount table loads
+    // and adds once the per-state Context is built. Scores are softmax logits: higher first.
+    struct MoveOrderModel {
+        static constexpr int kFeatureCount = 10;
+        static constexpr int kTableSize = 70;
+        using Features = std::array<uint8_t, kFeatureCount>;   // indices into weights
+
+        // Facts about the whole board, computed once per node and shared by all its moves.
+        struct Context {
+            uint32_t openTops{ 0 };          // bit c: colour c is the top of a bottle with room
+            uint32_t lockedClothTargets{ 0 };// bit c: a locked Cloth waits for colour c
+        };
+
+        std::array<float, kTableSize> weights{};
+
+        static Context context(const State& s);
+        static Features features(const State& s, const Context& ctx, const Move& m);
+        float score(const Features& f) const {
+            float sum = 0.0f;
+            for (uint8_t i : f) sum += weights[i];
+            return sum;
+        }
+        float score(const State& s, const Context& ctx, const Move& m) const { return score(features(s, ctx, m)); }
+    };
+
+    struct MoveOrderTrainStats {
+        size_t examples{ 0 };       // states with more than one legal move
+        size_t candidates{ 0 };     // legal moves over those states
+        double topOne{ 0.0 };       // share of states whose solution move scores highest
+        double meanRank{ 0.0 };     // average 0-based rank of the solution move
+        double baselineTopOne{ 0.0 };   // same share for the hand-written colour-match preference
+    };
+
+    // Collects (state, solution move) pairs and fits MoveOrderModel by softmax regression: each
+    // state's legal moves compete and the move the solution took is the label.
+    class MoveOrderTrainer {
+    public:
+        // One example per state along `solution` from `start` (normalised first, as the solvers do).
+        void addSolution(const State& start, const std::vector<Move>& solution);
+        size_t examples() const { return examplesList.size(); }
+        MoveOrderModel train(int epochs = 8, float learningRate = 0.05f, MoveOrderTrainStats* stats = nullptr) const;
+
+    private:
+        struct Example {
+            uint32_t first;     // into candidates
+            uint16_t count;
+            uint16_t target;    // solution move, relative to first
+            uint16_t baseline;  // rank of the solution move under the colour-match preference
+        };
+        std::vector<MoveOrderModel::Features> candidates;
+        std::vector<Example> examplesList;
+    };
+
+} // namespace ws
@@ -0,0 +1,240 @@
+// ========================= src/core/PackedState.cpp =========================
+#include "PackedState.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace ws {
+
+    bool isPackable(const State& s, std::string* reason) {
+        auto fail = [&](const char* why) {
+            if (reason) *reason = why;
+            return false;
+        };
+        if (s.B.empty()) return fail("No bottles.");
+        const int cap = s.B[0].capacity;
+        if (cap <= 0 || cap > 255) return fail("Capacity out of packed range.");
+        // Packed kernels pour whole runs; gimmick-only variants are fine since gimmicks are rejected below.
+        if (s.p.ruleSet == RuleSetId::SingleUnitPour) return fail("Packed kernels only implement whole-run pours.");
+
+        std::array<int, 21> counts{};
+        for (const auto& b : s.B) {
+            if (b.capacity != cap) return fail("Mixed bottle capacities.");
+            if (b.gimmick.kind != StackGimmickKind::None) return fail("Board has gimmicks.");
+            if (b.size() > cap) return fail("Overfilled bottle.");
+            for (const auto& sl : b.slots) {
+                if (sl.c < 1 || sl.c > 20) return fail("Colour out of range.");
+                ++counts[sl.c];
+            }
+        }
+        for (int c = 1; c <= 20; ++c) {
+            if (counts[c] % cap != 0) return fail("Colour count is not a multiple of the capacity.");
+        }
+        return true;
+    }
+
+    namespace {
+
+        // Hands out 8-byte aligned slices of one block; with base == nullptr it only measures.
+        struct Carver {
+            uint8_t* base{ nullptr };
+            size_t used{ 0 };
+
+            template <typename T>
+            T* take(size_t count) {
+                used = (used + 7) & ~(size_t)7;
+                T* out = base ? reinterpret_cast<T*>(base + used) : nullptr;
+                used += count * sizeof(T);
+                return out;
+            }
+        };
+
+    } // namespace
+
+    size_t PackedBatch::bytesFor(int laneCount, int bottleCount, int cap) {
+        Carver carver;
+        const size_t perBottle = (size_t)bottleCount * laneCount;
+        carver.take<uint8_t>(perBottle * cap); // cells
+        carver.take<uint8_t>(perBottle);       // height
+        carver.take<uint8_t>(perBottle);       // top
+        carver.take<uint8_t>(perBottle);       // chunk
+        carver.take<uint16_t>((size_t)21 * laneCount); // runs
+        carver.take<uint16_t>((size_t)21 * laneCount); // units
+        carver.take<int16_t>((size_t)laneCount);       // bound
+        carver.take<uint64_t>((size_t)laneCount);      // key
+        carver.take<uint64_t>((size_t)bottleCount * cap * 21); // zobrist
+        return carver.used;
+    }
+
+    void PackedBatch::bind(void* memory, int laneCount, int bottleCount, int cap) {
+        lanes = laneCount;
+        bottles = bottleCount;
+        capacity = cap;
+        const size_t bytes = bytesFor(laneCount, bottleCount, cap);
+        std::memset(memory, 0, bytes);
+
+        Carver carver{ static_cast<uint8_t*>(memory), 0 };
+        cells = carver.take<uint8_t>((size_t)bottles * capacity * lanes);
+        height = carver.take<uint8_t>((size_t)bottles * lanes);
+        top = carver.take<uint8_t>((size_t)bottles * lanes);
+        chunk = carver.take<uint8_t>((size_t)bottles * lanes);
+        runs = carver.take<uint16_t>((size_t)21 * lanes);
+        units = carver.take<uint16_t>((size_t)21 * lanes);
+        bound = carver.take<int16_t>((size_t)lanes);
+        key = carver.take<uint64_t>((size_t)lanes);
+        zobrist = carver.take<uint64_t>((size_t)bottles * capacity * 21);
+
+        // Fixed seed: keys only have to be consistent within one batch.
+        uint64_t z = 0x9E3779B97F4A7C15ull ^ ((uint64_t)bottles << 32) ^ (uint64_t)capacity;
+        for (size_t i = 0; i < (size_t)bottles * capacity * 21; ++i) {
+            z += 0x9E3779B97F4A7C15ull;
+            uint64_t x = z;
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+            zobrist[i] = x ^ (x >> 31);
+        }
+    }
+
+    void PackedBatch::load(int lane, const State& s) {
+        for (int c = 0; c <= 20; ++c) {
+            runs[at(c, lane)] = 0;
+            units[at(c, lane)] = 0;
+        }
+        uint64_t z = 0;
+        for (int b = 0; b < bottles; ++b) {
+            const auto& slots = s.B[b].slots;
+            const int h = (int)slots.size();
+            Color prev = 0;
+            for (int k = 0; k < capacity; ++k) {
+                const Color c = k < h ? slots[k].c : 0;
+                cells[at(b, k, lane)] = c;
+                if (k >= h) continue;
+                z ^= zobrist[((size_t)b * capacity + k) * 21 + c];
+                ++units[at(c, lane)];
+                if (c != prev) ++runs[at(c, lane)];
+                prev = c;
+            }
+            height[at(b, lane)] = (uint8_t)h;
+            top[at(b, lane)] = h > 0 ? slots[h - 1].c : 0;
+            int run = 0;
+            for (int k = h - 1; k >= 0 && slots[k].c == slots[h - 1].c; --k) ++run;
+            chunk[at(b, lane)] = (uint8_t)run;
+        }
+        int lb = 0;
+        for (int c = 1; c <= 20; ++c) {
+            units[at(c, lane)] = (uint16_t)(units[at(c, lane)] / capacity);
+            lb += std::max(0, (int)runs[at(c, lane)] - (int)units[at(c, lane)]);
+        }
+        bound[lane] = (int16_t)lb;
+        key[lane] = z;
+    }
+
+    void PackedBatch::store(int lane, State& out) const {
+        out.p.numBottles = bottles;
+        out.p.capacity = capacity;
+        out.B.assign(bottles, Bottle{});
+        for (int b = 0; b < bottles; ++b) {
+            auto& bottle = out.B[b];
+            bottle.capacity = capacity;
+            for (int k = 0; k < height[at(b, lane)]; ++k) bottle.slots.push_back(Slot{ cells[at(b, k, lane)], false });
+        }
+        out.refreshLocks();
+    }
+
+    void PackedBatch::moveCells(int lane, int from, int to, int amount) {
+        const size_t f = at(from, lane);
+        const size_t t = at(to, lane);
+        const uint8_t c = top[f];
+
+        // Only colour c changes its run count: the source loses its top run when it moves
+        // whole, the destination gains one unless the cells land on the same colour.
+        const size_t rc = at(c, lane);
+        const int before = std::max(0, (int)runs[rc] - (int)units[rc]);
+        if (amount == chunk[f]) --runs[rc];
+        if (height[t] == 0 || top[t] != c) ++runs[rc];
+        const int after = std::max(0, (int)runs[rc] - (int)units[rc]);
+        bound[lane] = (int16_t)(bound[lane] + after - before);
+
+        const int hf = height[f] - amount;
+        const int ht = height[t];
+        uint64_t z = key[lane];
+        for (int k = 0; k < amount; ++k) {
+            cells[at(to, ht + k, lane)] = c;
+            cells[at(from, hf + k, lane)] = 0;
+            z ^= zobrist[((size_t)to * capacity + ht + k) * 21 + c];
+            z ^= zobrist[((size_t)from * capacity + hf + k) * 21 + c];
+        }
+        key[lane] = z;
+        height[f] = (uint8_t)hf;
+        height[t] = (uint8_t)(ht + amount);
+
+        chunk[t] = (uint8_t)((ht > 0 && top[t] == c) ? chunk[t] + amount : amount);
+        top[t] = c;
+        if (amount < chunk[f]) {
+            chunk[f] = (uint8_t)(chunk[f] - amount);
+        }
+        else if (hf == 0) {
+            top[f] = 0;
+            chunk[f] = 0;
+        }
+        else {
+            const uint8_t below = cells[at(from, hf - 1, lane)];
+            int run = 0;
+            for (int k = hf - 1; k >= 0 && cells[at(from, k, lane)] == below; --k) ++run;
+            top[f] = below;
+            chunk[f] = (uint8_t)run;
+        }
+    }
+
+    void PackedBatch::copyLane(int dst, int src) {
+        if (dst == src) return;
+        for (int b = 0; b < bottles; ++b) {
+            for (int k = 0; k < capacity; ++k) cells[at(b, k, dst)] = cells[at(b, k, src)];
+            height[at(b, dst)] = height[at(b, src)];
+            top[at(b, dst)] = top[at(b, src)];
+            chunk[at(b, dst)] = chunk[at(b, src)];
+        }
+        for (int c = 0; c <= 20; ++c) {
+            runs[at(c, dst)] = runs[at(c, src)];
+            units[at(c, dst)] = units[at(c, src)];
+        }
+        bound[dst] = bound[src];
+        key[dst] = key[src];
+    }
+
+    void PackedBatch::pourAmounts(uint8_t* out, int count) const {
+        const uint8_t cap = (uint8_t)capacity;
+        for (int i = 0; i < bottles; ++i) {
+            const uint8_t* hi = &height[at(i, 0)];
+            const uint8_t* ti = &top[at(i, 0)];
+            const uint8_t* ci = &chunk[at(i, 0)];
+            for (int j = 0; j < bottles; ++j) {
+                uint8_t* dst = out + ((size_t)i * bottles + j) * lanes;
+                if (i == j) {
+                    std::fill(dst, dst + count, (uint8_t)0);
+                    continue;
+                }
+                const uint8_t* hj = &height[at(j, 0)];
+                const uint8_t* tj = &top[at(j, 0)];
+                for (int l = 0; l < count; ++l) {
+                    const uint8_t room = (uint8_t)(cap - hj[l]);
+                    const bool ok = hi[l] != 0 && room != 0 && (hj[l] == 0 || tj[l] == ti[l]);
+                    const uint8_t amt = ci[l] < room ? ci[l] : room;
+                    dst[l] = ok ? amt : (uint8_t)0;
+                }
+            }
+        }
+    }
+
+    void PackedBatch::refreshBounds() {
+        std::fill(bound, bound + lanes, (int16_t)0);
+        for (int c = 1; c <= 20; ++c) {
+            const uint16_t* r = &runs[at(c, 0)];
+            const uint16_t* u = &units[at(c, 0)];
+            for (int l = 0; l < lanes; ++l) {
+                const int surplus = (int)r[l] - (int)u[l];
+                bound[l] = (int16_t)(bound[l] + (surplus > 0 ? surplus : 0));
+            }
+        }
+    }
+
+} // namespace ws
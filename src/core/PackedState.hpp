@@ -0,0 +1,58 @@
+// ========================= src/core/PackedState.hpp =========================
+#pragma once
+#include "State.hpp"
+#include <string>
+
+namespace ws {
+
+    // Boards the packed kernels can handle: uniform capacity <= 255, no gimmicks, colours 1..20
+    // and every colour count a multiple of the capacity. '?' flags are ignored, as in
+    // Solver::normalizeForSolve. On such boards runLowerBound() == 0 exactly when solved.
+    bool isPackable(const State& s, std::string* reason = nullptr);
+
+    // Structure-of-arrays batch of same-shaped boards ("lanes"). Every per-bottle or per-colour
+    // field stores all lanes contiguously, so kernels that loop over lanes in the inner loop
+    // compile to straight vector code. The arrays live in memory the owner binds; nothing here
+    // allocates.
+    struct PackedBatch {
+        int lanes{ 0 };
+        int bottles{ 0 };
+        int capacity{ 0 };
+
+        uint8_t* cells{ nullptr };    // [(b * capacity + k) * lanes + lane], bottom -> top
+        uint8_t* height{ nullptr };   // [b * lanes + lane]
+        uint8_t* top{ nullptr };      // [b * lanes + lane] top colour, 0 when empty
+        uint8_t* chunk{ nullptr };    // [b * lanes + lane] length of the top run
+        uint16_t* runs{ nullptr };    // [c * lanes + lane] colour runs across the board, c = 0..20
+        uint16_t* units{ nullptr };   // [c * lanes + lane] bottles colour c fills when solved
+        int16_t* bound{ nullptr };    // [lane] Solver::runLowerBound of the current board
+        uint64_t* key{ nullptr };     // [lane] Zobrist key of the current board, kept by moveCells
+        uint64_t* zobrist{ nullptr }; // [(b * capacity + k) * 21 + c], fixed per shape
+
+        // Bytes bind() needs for this shape, including alignment padding.
+        static size_t bytesFor(int laneCount, int bottleCount, int cap);
+        // Lays the arrays out in `memory` (bytesFor() bytes, 8-byte aligned) and clears them.
+        void bind(void* memory, int laneCount, int bottleCount, int cap);
+        // `s` must satisfy isPackable() with this batch's bottles/capacity.
+        void load(int lane, const State& s);
+        // Copy of one lane back into a State (no gimmicks, no hidden flags).
+        void store(int lane, State& out) const;
+
+        // Moves `amount` cells of the top colour of `from` onto `to` and keeps the derived
+        // arrays in step. With from/to swapped it is also the exact undo of a pour.
+        void moveCells(int lane, int from, int to, int amount);
+
+        // Overwrites lane `dst` with lane `src`; used to keep live lanes packed at the front.
+        void copyLane(int dst, int src);
+
+        // Kernel: legal pour amount for every (from, to) pair of the first `count` lanes, 0 when
+        // illegal. `out` holds bottles * bottles * lanes entries laid out [(from * bottles + to) * lanes + lane].
+        void pourAmounts(uint8_t* out, int count) const;
+        // Kernel: recompute `bound` for every lane from `runs` and `units`.
+        void refreshBounds();
+
+        size_t at(int b, int k, int lane) const { return ((size_t)b * capacity + k) * lanes + lane; }
+        size_t at(int b, int lane) const { return (size_t)b * lanes + lane; }
+    };
+
+} // namespace ws
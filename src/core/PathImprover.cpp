@@ -0,0 +1,270 @@
+// ========================= src/core/PathImprover.cpp =========================
+#include "PathImprover.hpp"
+#include "MoveOrder.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace ws {
+
+    namespace {
+
+        struct Trace { int parent{ -1 }; Move m{}; };
+
+        std::vector<Move> legalMoves(const State& s) {
+            std::vector<Move> out;
+            for (int i = 0; i < (int)s.B.size(); ++i) {
+                for (int j = 0; j < (int)s.B.size(); ++j) {
+                    int amt = 0;
+                    if (i == j || !s.canPour(i, j, &amt)) continue;
+                    out.push_back(Move{ i,j,amt });
+                }
+            }
+            return out;
+        }
+
+        std::vector<Move> rebuild(const std::vector<Trace>& trace, int node) {
+            std::vector<Move> out;
+            for (int k = node; k >= 0; k = trace[k].parent) out.push_back(trace[k].m);
+            std::reverse(out.begin(), out.end());
+            return out;
+        }
+
+        // States along the path, states[0] == start and states[k] after k moves.
+        std::vector<State> replayStates(const State& start, const std::vector<Move>& path) {
+            std::vector<State> states;
+            states.reserve(path.size() + 1);
+            states.push_back(start);
+            for (const auto& m : path) {
+                State next = states.back();
+                next.apply(m);
+                states.push_back(std::move(next));
+            }
+            return states;
+        }
+
+        bool isFeasible(const State& start, const std::vector<Move>& path) {
+            State s = start;
+            for (const auto& m : path) {
+                int amt = 0;
+                if (!s.canPour(m.from, m.to, &amt)) return false;
+                if (m.amount > 0 && m.amount != amt) return false;
+                s.apply(Move{ m.from,m.to,amt });
+            }
+            return s.isSolved();
+        }
+
+        // Beam ranking: every colour run counts, plus every
+        // extra bottle a colour is spread over. Not admissible; only used to pick survivors.
+        int beamScore(const State& s) {
+            std::array<int, 21> spread{};
+            int score = 0;
+            for (const auto& b : s.B) {
+                std::array<bool, 21> here{};
+                Color prev = 0;
+                for (const auto& sl : b.slots) {
+                    if (sl.c == prev) continue;
+                    prev = sl.c;
+                    ++score;
+                    if (sl.c >= 1 && sl.c <= 20 && !here[sl.c]) { here[sl.c] = true; ++spread[sl.c]; }
+                }
+            }
+            for (int c = 1; c <= 20; ++c) score += std::max(0, spread[c] - 1);
+            return score;
+        }
+
+        // Any solution, greedily: keep the `width` lowest-heuristic states of each layer. With a move
+        // order model, ties go to the child reached by the higher-scoring move.
+        std::optional<std::vector<Move>> beamSearch(const State& start, int width, const MoveOrderModel* moveOrder,
+            const std::function<bool()>& timeOk) {
+            struct Entry { State s; int node; int h; float prior; };
+            std::vector<Trace> trace;
+            std::vector<Entry> layer;
+            layer.push_back({ start, -1, beamScore(start), 0.0f });
+            std::unordered_set<size_t> seen{ start.hash() };
+
+            // A greedy beam that has not finished within a few moves per cell is wandering; widen instead.
+            int cells = 0;
+            for (const auto& b : start.B) cells += b.size();
+            const int maxDepth = std::max(16, 4 * cells);
+            for (int depth = 0; depth < maxDepth && !layer.empty(); ++depth) {
+                std::vector<Entry> next;
+                for (const auto& e : layer) {
+                    if (!timeOk()) return std::nullopt;
+                    MoveOrderModel::Context ctx;
+                    if (moveOrder) ctx = MoveOrderModel::context(e.s);
+                    for (const auto& m : legalMoves(e.s)) {
+                        const float prior = moveOrder ? moveOrder->score(e.s, ctx, m) : 0.0f;
+                        State child = e.s;
+                        child.apply(m);
+                        if (!seen.insert(child.hash()).second) continue;
+                        trace.push_back({ e.node, m });
+                        const int id = (int)trace.size() - 1;
+                        if (child.isSolved()) return rebuild(trace, id);
+                        const int h = beamScore(child);
+                        next.push_back({ std::move(child), id, h, prior });
+                    }
+                }
+                if ((int)next.size() > width) {
+                    std::nth_element(next.begin(), next.begin() + width, next.end(),
+                        [](const Entry& a, const Entry& b) { return a.h != b.h ? a.h < b.h : a.prior > b.prior; });
+                    next.erase(next.begin() + width, next.end());
+                }
+                layer.swap(next);
+            }
+            return std::nullopt;
+        }
+
+        // Full comparison behind a hash match: a 64-bit collision must not splice in a wrong path.
+        bool sameBoard(const State& a, const State& b) {
+            if (a.B.size() != b.B.size()) return false;
+            for (size_t k = 0; k < a.B.size(); ++k) {
+                const Bottle& x = a.B[k];
+                const Bottle& y = b.B[k];
+                if (x.capacity != y.capacity || x.gimmick.kind != y.gimmick.kind || x.gimmick.clothTarget != y.gimmick.clothTarget) return false;
+                if (x.slots.size() != y.slots.size()) return false;
+                for (size_t c = 0; c < x.slots.size(); ++c) {
+                    if (x.slots[c].c != y.slots[c].c || x.slots[c].hidden != y.slots[c].hidden) return false;
+                }
+            }
+            return true;
+        }
+
+        // Furthest path index of every state on the path; revisits collapse to the later copy.
+        std::unordered_map<size_t, size_t> indexStates(const std::vector<State>& states) {
+            std::unordered_map<size_t, size_t> at;
+            at.reserve(states.size() * 2);
+            for (size_t j = 0; j < states.size(); ++j) at[states[j].hash()] = j;
+            return at;
+        }
+
+        // Shortest re-route out of states[i]: BFS up to `shortcutDepth` moves, looking for any later
+        // path state (or a solved state) reached in fewer moves than the path spends getting there.
+        bool improveWindow(std::vector<Move>& path, const std::vector<State>& states,
+            const std::unordered_map<size_t, size_t>& at, size_t i,
+            const ImproveOptions& opt, const std::function<bool()>& timeOk) {
+            const size_t n = path.size();
+
+            // Loops on the path are free to cut.
+            if (auto it = at.find(states[i].hash()); it != at.end() && it->second > i && sameBoard(states[i], states[it->second])) {
+                path.erase(path.begin() + (long)i, path.begin() + (long)it->second);
+                return true;
+            }
+
+            std::vector<Trace> trace;
+            std::vector<std::pair<State, int>> frontier;
+            frontier.emplace_back(states[i], -1);
+            std::unordered_set<size_t> seen{ states[i].hash() };
+
+            int bestGain = 0;
+            int bestNode = -1;
+            size_t bestJ = 0;
+            bool stop = false;
+            const int maxDepth = std::max(1, opt.shortcutDepth);
+            for (int depth = 1; depth <= maxDepth && !stop && !frontier.empty(); ++depth) {
+                std::vector<std::pair<State, int>> next;
+                for (const auto& [s, node] : frontier) {
+                    if (!timeOk() || (int)trace.size() > opt.windowNodeLimit) { stop = true; break; }
+                    for (const auto& m : legalMoves(s)) {
+                        State child = s;
+                        child.apply(m);
+                        const size_t h = child.hash();
+                        if (!seen.insert(h).second) continue;
+                        trace.push_back({ node, m });
+                        const int id = (int)trace.size() - 1;
+
+                        size_t j = 0;
+                        if (child.isSolved()) j = n;
+                        else if (auto it = at.find(h); it != at.end() && sameBoard(child, states[it->second])) j = it->second;
+                        if (j > i) {
+                            const int gain = (int)(j - i) - depth;
+                            if (gain > bestGain) { bestGain = gain; bestNode = id; bestJ = j; }
+                        }
+                        next.emplace_back(std::move(child), id);
+                    }
+                }
+                frontier.swap(next);
+            }
+            if (bestGain <= 0) return false;
+
+            std::vector<Move> spliced(path.begin(), path.begin() + (long)i);
+            for (const auto& m : rebuild(trace, bestNode)) spliced.push_back(m);
+            spliced.insert(spliced.end(), path.begin() + (long)bestJ, path.end());
+            path.swap(spliced);
+            return true;
+        }
+
+    } // namespace
+
+    ImproveResult PathImprover::improve(const State& start, const std::vector<Move>* seed) {
+        using clock = std::chrono::steady_clock;
+        auto t0 = clock::now();
+        std::function<bool()> timeOk = [&] {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - t0).count() < opt.timeBudgetMs;
+        };
+
+        const State s0 = Solver::normalizeForSolve(start);
+        ImproveResult result;
+        const bool startSolved = s0.isSolved();
+        result.lowerBound = std::max({ opt.lowerBound, Solver::runLowerBound(s0), startSolved ? 0 : 1 });
+        if (startSolved) {
+            result.found = true;
+            result.initialLength = result.bestLength = 0;
+            result.lowerBound = 0;
+            result.gap = 0;
+            return result;
+        }
+
+        std::vector<Move> path;
+        if (seed && isFeasible(s0, *seed)) {
+            path = *seed;
+        }
+        else {
+            const int maxWidth = 1 << 14;
+            for (int width = std::max(1, opt.beamWidth); width <= maxWidth; width *= 2) {
+                if (auto found = beamSearch(s0, width, opt.moveOrder, timeOk)) { path = std::move(*found); break; }
+                if (!timeOk()) break;
+            }
+            if (path.empty()) {
+                result.timedOut = !timeOk();
+                return result;
+            }
+        }
+        result.found = true;
+        result.initialLength = (int)path.size();
+
+        while (timeOk() && (int)path.size() > result.lowerBound) {
+            ++result.passes;
+            bool improved = false;
+            auto states = replayStates(s0, path);
+            auto at = indexStates(states);
+            for (size_t i = 0; i + 1 < path.size() && timeOk();) {
+                const std::vector<Move> before = path;
+                if (improveWindow(path, states, at, i, opt, timeOk)) {
+                    // Belt and braces: never hand back a spliced path that no longer replays.
+                    if (!isFeasible(s0, path)) {
+                        path = before;
+                        ++i;
+                        continue;
+                    }
+                    improved = true;
+                    states = replayStates(s0, path);
+                    at = indexStates(states);
+                    continue; // the shorter path may open another shortcut from the same state
+                }
+                ++i;
+            }
+            if (!improved) break;
+        }
+
+        result.timedOut = !timeOk();
+        result.bestLength = (int)path.size();
+        result.gap = result.bestLength - result.lowerBound;
+        result.path = std::move(path);
+        return result;
+    }
+
+} // namespace ws
@@ -0,0 +1,42 @@
+// ========================= src/core/PathImprover.hpp =========================
+#pragma once
+#include "Solver.hpp"
+#include <optional>
+
+namespace ws {
+
+    struct ImproveOptions {
+        int timeBudgetMs{ 3000 };
+        int beamWidth{ 64 };          // width of the first feasible-solution beam (doubled on failure)
+        int shortcutDepth{ 4 };       // longest replacement segment tried from each path state
+        int windowNodeLimit{ 20000 }; // BFS node cap per path state
+        int lowerBound{ 0 };          // externally proven bound, e.g. SolveResult::lowerBound of a timed-out solve
+        const MoveOrderModel* moveOrder{ nullptr };  // breaks beam heuristic ties by learned move score
+    };
+
+    struct ImproveResult {
+        bool found{ false };
+        bool timedOut{ false };
+        std::vector<Move> path;   // best feasible solution found
+        int initialLength{ -1 };  // length of the seed / beam solution
+        int bestLength{ -1 };
+        int lowerBound{ 0 };      // best proven lower bound on the optimum
+        int gap{ -1 };            // bestLength - lowerBound
+        int passes{ 0 };
+    };
+
+    // Anytime improvement for maps beyond optimal-solve reach: start from any feasible path
+    // (caller-supplied or beam search) and repeatedly replace windows of it with the shortest
+    // connection between its intermediate states until a full pass finds nothing shorter.
+    // Each window starts at a path state and ends at any later one, so long detours collapse too.
+    class PathImprover {
+    public:
+        explicit PathImprover(ImproveOptions o = {}) :opt(o) {}
+
+        ImproveResult improve(const State& start, const std::vector<Move>* seed = nullptr);
+
+    private:
+        ImproveOptions opt;
+    };
+
+} // namespace ws
@@ -0,0 +1,239 @@
+// ========================= src/core/Rules.hpp =========================
+#pragma once
+#include "State.hpp"
+#include "BottleTable.hpp"
+#include <algorithm>
+
+namespace ws {
+
+    // Gameplay rules as policy classes. A rule set picks one policy per axis at compile time and
+    // RuleEngine<Rules> is the move generator / pour / reveal / lock code built from them, so an
+    // instantiation carries no branches for variants it does not use. State's member functions
+    // dispatch on Params::ruleSet once per call; the solvers dispatch once per solve and stay on
+    // RuleEngine<Rules> inside the search.
+    namespace rules {
+
+        // --- pour amount ---
+        struct PourWholeRun {
+            static int amount(int topRun, int room) { return std::min(topRun, room); }
+        };
+        struct PourSingleUnit {
+            static int amount(int topRun, int room) { return (topRun > 0 && room > 0) ? 1 : 0; }
+        };
+
+        // --- vine ---
+        struct VinePourInOnly {
+            static bool canPourOut(const Bottle& b) { return b.gimmick.kind != StackGimmickKind::Vine; }
+        };
+
+        // --- bush ---
+        struct BushEitherNeighbour {
+            static bool released(const std::vector<Bottle>& B, size_t i) {
+                const bool leftOk = (i > 0 && B[i - 1].isMonoFull());
+                const bool rightOk = (i + 1 < B.size() && B[i + 1].isMonoFull());
+                return leftOk || rightOk;
+            }
+        };
+        // Only the left neighbour counts (the right one for a bush in the first slot).
+        struct BushOneNeighbour {
+            static bool released(const std::vector<Bottle>& B, size_t i) {
+                const size_t n = i > 0 ? i - 1 : i + 1;
+                return n < B.size() && B[n].isMonoFull();
+            }
+        };
+
+        // --- '?' reveal ---
+        struct RevealSameColourChain {
+            // The cell at openedIndex just became visible: hidden cells directly below it open
+            // too while they have the same colour.
+            static void below(Bottle& bottle, int openedIndex) {
+                if (openedIndex < 0 || openedIndex >= (int)bottle.slots.size()) return;
+                int idx = openedIndex;
+                while (idx - 1 >= 0) {
+                    auto& upper = bottle.slots[idx];
+                    auto& lower = bottle.slots[idx - 1];
+                    if (!lower.hidden) break;
+                    if (lower.c != upper.c) break;
+                    lower.hidden = false;
+                    --idx;
+                }
+            }
+        };
+
+        template <RuleSetId Id, class Pour, class Vine, class Bush, class Reveal>
+        struct RuleSet {
+            static constexpr RuleSetId id = Id;
+            using PourRule = Pour;
+            using VineRule = Vine;
+            using BushRule = Bush;
+            using RevealRule = Reveal;
+        };
+
+        using Classic = RuleSet<RuleSetId::Classic, PourWholeRun, VinePourInOnly, BushEitherNeighbour, RevealSameColourChain>;
+        using SingleUnit = RuleSet<RuleSetId::SingleUnitPour, PourSingleUnit, VinePourInOnly, BushEitherNeighbour, RevealSameColourChain>;
+        using OneNeighbourBush = RuleSet<RuleSetId::BushOneNeighbour, PourWholeRun, VinePourInOnly, BushOneNeighbour, RevealSameColourChain>;
+
+        // Calls fn(RuleSetType{}) for the given id; unknown ids fall back to Classic.
+        template <class Fn>
+        decltype(auto) dispatch(RuleSetId id, Fn&& fn) {
+            switch (id) {
+            case RuleSetId::SingleUnitPour: return fn(SingleUnit{});
+            case RuleSetId::BushOneNeighbour: return fn(OneNeighbourBush{});
+            default: return fn(Classic{});
+            }
+        }
+
+    } // namespace rules
+
+    template <class Rules>
+    struct RuleEngine {
+        // Cloth / Bush bottle that is currently locked.
+        static bool locked(const State& s, int i) {
+            const auto kind = s.B[i].gimmick.kind;
+            return (kind == StackGimmickKind::Cloth && s.locks.clothLocked[i]) ||
+                (kind == StackGimmickKind::Bush && s.locks.bushLocked[i]);
+        }
+
+        static void refreshLocks(State& s) {
+            s.locks.bushLocked.assign(s.B.size(), false);
+            s.locks.clothLocked.assign(s.B.size(), false);
+
+            // Precompute which colors are already completed in some bottle
+            std::array<bool, 21> colorCompleted{}; // colors 1..20
+            for (size_t i = 0; i < s.B.size(); ++i) {
+                if (s.B[i].isMonoFull()) colorCompleted[s.B[i].slots[0].c] = true;
+            }
+
+            for (size_t i = 0; i < s.B.size(); ++i) {
+                const auto& g = s.B[i].gimmick;
+                if (g.kind == StackGimmickKind::Cloth) {
+                    if (g.clothTarget >= 1 && g.clothTarget <= 20) {
+                        s.locks.clothLocked[i] = !colorCompleted[g.clothTarget];
+                    }
+                }
+                else if (g.kind == StackGimmickKind::Bush) {
+                    s.locks.bushLocked[i] = !Rules::BushRule::released(s.B, i);
+                }
+            }
+        }
+
+        static bool canPour(const State& s, int from, int to, int* outAmount) {
+            if (from == to || from < 0 || to < 0 || from >= (int)s.B.size() || to >= (int)s.B.size()) return false;
+            const auto& bf = s.B[from];
+            const auto& bt = s.B[to];
+
+            if (!Rules::VineRule::canPourOut(bf)) return false;
+
+            // Cloth / Bush: if locked, cannot use this bottle at all (no in/out)
+            if (locked(s, from) || locked(s, to)) return false;
+
+            if (bf.slots.empty()) return false;
+            if (bt.size() >= bt.capacity) return false;
+
+            Color tcol = bf.topColor();
+            if (tcol == 0) return false;
+
+            Color destTop = bt.topColor();
+            if (destTop != 0 && destTop != tcol) return false;
+
+            int mv = Rules::PourRule::amount(bf.topChunk(), bt.capacity - bt.size());
+            if (mv <= 0) return false;
+            if (outAmount) *outAmount = mv;
+            return true;
+        }
+
+        // canPour with both contents read from BottleTable entries instead of the slots; same
+        // result as canPour(s, from, to, outAmount) for bottles the table encodes.
+        static bool canPour(const State& s, int from, int to, const BottleInfo& f, const BottleInfo& t, int* outAmount) {
+            if (f.height == 0 || t.height >= s.B[to].capacity) return false;
+            if (t.height != 0 && t.top != f.top) return false;
+            if (!Rules::VineRule::canPourOut(s.B[from]) || locked(s, from) || locked(s, to)) return false;
+            int mv = Rules::PourRule::amount(f.run, s.B[to].capacity - t.height);
+            if (mv <= 0) return false;
+            if (outAmount) *outAmount = mv;
+            return true;
+        }
+
+        static void apply(State& s, const Move& m) {
+            if (m.from < 0 || m.to < 0) return;
+            auto& f = s.B[m.from];
+            auto& t = s.B[m.to];
+            int amount = m.amount;
+            if (amount <= 0) {
+                int calc = 0; if (!canPour(s, m.from, m.to, &calc)) return; amount = calc;
+            }
+            for (int i = 0; i < amount; ++i) {
+                auto sl = f.slots.back();
+                const bool wasHidden = sl.hidden;
+                sl.hidden = false; // when leaving source top, it's revealed already
+                t.slots.push_back(sl);
+                if (wasHidden) {
+                    Rules::RevealRule::below(t, (int)t.slots.size() - 1);
+                }
+                f.slots.pop_back();
+            }
+            // After move, revealing rule: if new top of any bottle has hidden=true and is now at top, it becomes visible
+            if (!f.slots.empty() && f.slots.back().hidden) {
+                f.slots.back().hidden = false;
+                Rules::RevealRule::below(f, (int)f.slots.size() - 1);
+            }
+            if (!t.slots.empty() && t.slots.back().hidden) {
+                t.slots.back().hidden = false;
+                Rules::RevealRule::below(t, (int)t.slots.size() - 1);
+            }
+
+            // update locks (mono full may have changed)
+            refreshLocks(s);
+        }
+
+        static bool isSolved(const State& s) {
+            for (const auto& b : s.B) {
+                if (!b.slots.empty() && !b.isMonoFull()) return false;
+                for (const auto& sl : b.slots) {
+                    if (sl.hidden) return false;
+                }
+            }
+
+            // Perfect clear policy: all gimmick locks must be released.
+            std::array<bool, 21> colorCompleted{}; // colors 1..20
+            for (const auto& b : s.B) {
+                if (b.isMonoFull()) colorCompleted[b.slots[0].c] = true;
+            }
+
+            for (size_t i = 0; i < s.B.size(); ++i) {
+                const auto& g = s.B[i].gimmick;
+                if (g.kind == StackGimmickKind::Cloth) {
+                    if (!(g.clothTarget >= 1 && g.clothTarget <= 20 && colorCompleted[g.clothTarget])) return false;
+                }
+                else if (g.kind == StackGimmickKind::Bush) {
+                    if (!Rules::BushRule::released(s.B, i)) return false;
+                }
+            }
+            return true;
+        }
+
+        // isSolved with the per-bottle test read from `table`; `codes` as BottleTable::encode(s)
+        // gives them. Only boards whose every bottle is empty or mono-full reach the lock checks.
+        static bool isSolved(const State& s, const BottleTable& table, const uint32_t* codes) {
+            for (size_t i = 0; i < s.B.size(); ++i) {
+                const BottleInfo& e = table[codes[i]];
+                if (e.height != 0 && !e.monoFull) return false;
+            }
+            return isSolved(s);
+        }
+
+        // Move generator: fn(Move) for every legal pour, from-major order.
+        template <class Fn>
+        static void forEachMove(const State& s, Fn&& fn) {
+            const int n = (int)s.B.size();
+            for (int i = 0; i < n; ++i) {
+                for (int j = 0; j < n; ++j) {
+                    int amt = 0;
+                    if (i == j || !canPour(s, i, j, &amt)) continue;
+                    fn(Move{ i,j,amt });
+                }
+            }
+        }
+    };
+
+} // namespace ws
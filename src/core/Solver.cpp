@@ -1,6 +1,16 @@
 ﻿// ========================= src/core/Solver.cpp =========================
 #include "Solver.hpp"
+#include "Rules.hpp"
+#include "BottleTable.hpp"
+#include "MoveOrder.hpp"
+#include "FixedSolver.hpp"
 #include <queue>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 #include <unordered_set>
 #include <unordered_map>
 #include <chrono>
@@ -11,7 +21,7 @@ namespace ws {
 
     struct Node { State s; int g{ 0 }; };
 
-    static State normalizeForSolve(const State& input) {
+    State Solver::normalizeForSolve(const State& input) {
         State normalized = input;
         for (auto& bottle : normalized.B) {
             for (auto& slot : bottle.slots) {
@@ -23,21 +33,59 @@ namespace ws {
     }
 
     // Lightweight IDDFS with heuristic cutoff; transposition table prunes repeats.
+    int Solver::heuristicTerm(const Bottle& b) {
+        if (b.slots.empty() || b.isMonoFull()) return 0;
+        // number of color groups in bottle minus 1
+        int groups = 0; Color prev = 0; for (auto& sl : b.slots) { if (sl.c != prev) { if (sl.c != 0) ++groups; prev = sl.c; } }
+        return std::max(1, groups - 1);
+    }
+
     static int heuristic(const State& s) {
         // Heuristic: count bottles needing work + color fragmentation penalty
         int h = 0; int empty = 0;
         for (const auto& b : s.B) {
             if (b.slots.empty()) { ++empty; continue; }
-            if (!b.isMonoFull()) {
-                // number of color groups in bottle minus 1
-                int groups = 0; Color prev = 0; for (auto& sl : b.slots) { if (sl.c != prev) { if (sl.c != 0) ++groups; prev = sl.c; } }
-                h += std::max(1, groups - 1);
-            }
+            h += Solver::heuristicTerm(b);
         }
         h = std::max(0, h - std::min(2, empty));
         return h;
     }
 
+    // heuristic() from table entries; `codes` as BottleTable::encode(s) gives them.
+    static int heuristic(const BottleTable& table, const uint32_t* codes, size_t count) {
+        int h = 0; int empty = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const BottleInfo& e = table[codes[i]];
+            if (e.height == 0) ++empty;
+            else h += e.heuristic;
+        }
+        return std::max(0, h - std::min(2, empty));
+    }
+
+    int Solver::runLowerBound(const State& s) {
+        // A pour merges at most one pair of same-coloured runs, and a solved board keeps at
+        // least ceil(count / capacity) runs per colour, so the surplus runs each cost a move.
+        std::array<int, 21> runs{};
+        std::array<int, 21> cells{};
+        int maxCap = 1;
+        for (const auto& b : s.B) {
+            maxCap = std::max(maxCap, b.capacity);
+            Color prev = 0;
+            for (const auto& sl : b.slots) {
+                if (sl.c < 1 || sl.c > 20) continue;
+                ++cells[sl.c];
+                if (sl.c != prev) ++runs[sl.c];
+                prev = sl.c;
+            }
+        }
+        int lb = 0;
+        for (int c = 1; c <= 20; ++c) {
+            if (cells[c] == 0) continue;
+            lb += std::max(0, runs[c] - (cells[c] + maxCap - 1) / maxCap);
+        }
+        return lb;
+    }
+
     struct SolutionCountResult {
         int count{ 0 };
         bool exhaustive{ false };
@@ -45,6 +93,77 @@ namespace ws {
         bool limitHit{ false };
     };
 
+    // Solutions are counted as traces: two optimal lines that differ only in the order of
+    // independent pours are one solution. A pour that leaves the mono-full status of both its
+    // bottles unchanged cannot change any lock, so two such pours on disjoint bottles commute
+    // (either order is legal and ends in the same state). Without Cloth or Bush bottles there
+    // are no locks and any two pours on disjoint bottles commute.
+    struct TraceStep { Move m; bool neutral; };
+
+    static bool commute(const TraceStep& a, const TraceStep& b) {
+        return a.neutral && b.neutral &&
+            a.m.from != b.m.from && a.m.from != b.m.to && a.m.to != b.m.from && a.m.to != b.m.to;
+    }
+
+    // Only the lexicographically least interleaving of each trace is searched: appending `a` is
+    // rejected when some earlier step sorts after it and `a` commutes with that step and every
+    // step since.
+    static bool keepsNormalForm(const std::vector<TraceStep>& path, const TraceStep& a) {
+        for (size_t k = path.size(); k-- > 0;) {
+            const TraceStep& b = path[k];
+            if (!commute(a, b)) return true;
+            if (a.m.from != b.m.from ? a.m.from < b.m.from : a.m.to < b.m.to) return false;
+        }
+        return true;
+    }
+
+    static bool hasLockGimmicks(const State& s) {
+        for (const auto& b : s.B) {
+            if (b.gimmick.kind == StackGimmickKind::Cloth || b.gimmick.kind == StackGimmickKind::Bush) return true;
+        }
+        return false;
+    }
+
+    // Children of `cur` that keep the path in normal form, colour-matching pours first.
+    template <class Rules>
+    static void traceChildren(const State& cur, const std::vector<TraceStep>& path, bool lockFree,
+        std::vector<std::pair<TraceStep, State>>& out) {
+        out.clear();
+        // Both passes test every pair, so encode the board once and filter on table entries.
+        thread_local std::vector<uint32_t> codes;
+        const BottleTable* table = BottleTable::forState(cur);
+        if (table && !table->encode(cur, codes)) table = nullptr;
+        for (int pass = 0; pass < 2; ++pass) {
+            for (int i = 0; i < (int)cur.B.size(); ++i) {
+                for (int j = 0; j < (int)cur.B.size(); ++j) {
+                    if (i == j) continue;
+                    int amt = 0;
+                    bool prefer = false;
+                    if (table) {
+                        const BottleInfo& f = (*table)[codes[(size_t)i]];
+                        const BottleInfo& t = (*table)[codes[(size_t)j]];
+                        if (!RuleEngine<Rules>::canPour(cur, i, j, f, t, &amt)) continue;
+                        prefer = t.height != 0 && f.top == t.top;
+                    }
+                    else {
+                        if (!RuleEngine<Rules>::canPour(cur, i, j, &amt)) continue;
+                        prefer = !cur.B[j].isEmpty() && cur.B[i].topColor() == cur.B[j].topColor();
+                    }
+                    if (prefer != (pass == 0)) continue;
+                    State next = cur;
+                    const Move m{ i, j, amt };
+                    RuleEngine<Rules>::apply(next, m);
+                    const bool neutral = lockFree ||
+                        (cur.B[i].isMonoFull() == next.B[i].isMonoFull() && cur.B[j].isMonoFull() == next.B[j].isMonoFull());
+                    const TraceStep step{ m, neutral };
+                    if (!keepsNormalForm(path, step)) continue;
+                    out.emplace_back(step, std::move(next));
+                }
+            }
+        }
+    }
+
+    template <class Rules>
     static SolutionCountResult countMinimalSolutions(const State& start, int depthLimit, int maxCount, const std::function<bool()>& timeOk) {
         SolutionCountResult result;
         if (depthLimit < 0) {
@@ -52,15 +171,20 @@ namespace ws {
             return result;
         }
 
+        // Shallowest depth each state was reached at. A state reached deeper than that cannot lie
+        // on an optimal line; equal depths are searched again since they may be distinct traces.
         std::unordered_map<size_t, int> bestDepth;
         bestDepth.reserve(4096);
         bestDepth[start.hash()] = 0;
+        const bool lockFree = !hasLockGimmicks(start);
+        std::vector<TraceStep> path;
+        path.reserve((size_t)depthLimit);
 
         std::function<void(const State&, int)> dfs = [&](const State& cur, int depth) {
             if (result.timedOut || result.limitHit) return;
             if (!timeOk()) { result.timedOut = true; return; }
 
-            if (cur.isSolved()) {
+            if (RuleEngine<Rules>::isSolved(cur)) {
                 if (depth <= depthLimit) {
                     ++result.count;
                     if (result.count >= maxCount) {
@@ -70,34 +194,18 @@ namespace ws {
                 return;
             }
 
-            if (depth >= depthLimit) return;
-
-            struct Candidate { Move m; bool prefer; };
-            std::vector<Candidate> cand;
-            cand.reserve(cur.B.size() * cur.B.size());
-
-            for (int i = 0; i < (int)cur.B.size(); ++i) {
-                for (int j = 0; j < (int)cur.B.size(); ++j) {
-                    if (i == j) continue;
-                    int amt = 0;
-                    if (!cur.canPour(i, j, &amt)) continue;
-                    bool prefer = !cur.B[j].isEmpty() && cur.B[i].topColor() == cur.B[j].topColor();
-                    cand.push_back({ Move{i,j,amt}, prefer });
-                }
-            }
+            if (depth + Solver::runLowerBound(cur) > depthLimit) return;
 
-            std::stable_sort(cand.begin(), cand.end(), [](const Candidate& a, const Candidate& b) {
-                return a.prefer > b.prefer;
-                });
-
-            for (const auto& c : cand) {
-                State next = cur;
-                next.apply(c.m);
-                size_t h = next.hash();
+            std::vector<std::pair<TraceStep, State>> children;
+            traceChildren<Rules>(cur, path, lockFree, children);
+            for (const auto& [step, next] : children) {
+                const size_t h = next.hash();
                 auto it = bestDepth.find(h);
-                if (it != bestDepth.end() && it->second <= depth + 1) continue;
+                if (it != bestDepth.end() && it->second < depth + 1) continue;
                 bestDepth[h] = depth + 1;
+                path.push_back(step);
                 dfs(next, depth + 1);
+                path.pop_back();
                 if (result.timedOut || result.limitHit) return;
             }
             };
@@ -107,39 +215,321 @@ namespace ws {
         return result;
     }
 
-    SolveResult Solver::solve(const State& start) {
+    // bestDepth shared by the counting workers, sharded so claims rarely contend.
+    class SharedDepthTable {
+    public:
+        // Records `depth` for `h`; false when the state was already reached strictly shallower.
+        bool claim(size_t h, int depth) {
+            Shard& shard = shards[(h ^ (h >> 29)) & (kShards - 1)];
+            std::lock_guard<std::mutex> lock(shard.m);
+            auto [it, inserted] = shard.map.try_emplace(h, depth);
+            if (inserted) return true;
+            if (it->second < depth) return false;
+            it->second = depth;
+            return true;
+        }
+
+    private:
+        static constexpr size_t kShards = 64;
+        struct Shard {
+            std::mutex m;
+            std::unordered_map<size_t, int> map;
+        };
+        std::array<Shard, kShards> shards;
+    };
+
+    // Same depth-limited DFS as countMinimalSolutions, spread over `workers` threads. Workers
+    // start from a shared task queue seeded with the root; while any worker is idle, a busy one
+    // hands over the remaining children of its current node instead of descending into them,
+    // so the split follows wherever the tree turns out to be bushy.
+    template <class Rules>
+    class ParallelSolutionCounter {
+    public:
+        ParallelSolutionCounter(int depthLimit, int maxCount, int workers, const std::function<bool()>& timeOk)
+            : depthLimit(depthLimit), maxCount(maxCount), workers(workers), timeOk(timeOk) {}
+
+        SolutionCountResult run(const State& start) {
+            table.claim(start.hash(), 0);
+            lockFree = !hasLockGimmicks(start);
+            queue.push_back(Task{ start, 0, {} });
+            std::vector<std::thread> pool;
+            for (int w = 1; w < workers; ++w) pool.emplace_back([this] { workerLoop(); });
+            workerLoop();
+            for (auto& t : pool) t.join();
+
+            SolutionCountResult result;
+            result.count = std::min(count.load(), maxCount);
+            result.timedOut = timedOut.load();
+            result.limitHit = limitHit.load();
+            result.exhaustive = !result.timedOut && !result.limitHit;
+            return result;
+        }
+
+    private:
+        struct Task { State s; int depth; std::vector<TraceStep> path; };
+
+        const int depthLimit;
+        const int maxCount;
+        const int workers;
+        const std::function<bool()>& timeOk;
+        bool lockFree{ false };
+        SharedDepthTable table;
+        std::atomic<int> count{ 0 };
+        std::atomic<bool> stop{ false };
+        std::atomic<bool> timedOut{ false };
+        std::atomic<bool> limitHit{ false };
+        std::mutex m;
+        std::condition_variable cv;
+        std::deque<Task> queue;     // guarded by m
+        std::atomic<int> idle{ 0 }; // written under m, read as a hint while searching
+
+        void halt() {
+            std::lock_guard<std::mutex> lock(m);
+            stop.store(true);
+            cv.notify_all();
+        }
+
+        void workerLoop() {
+            while (true) {
+                Task task;
+                {
+                    std::unique_lock<std::mutex> lock(m);
+                    idle.fetch_add(1);
+                    if (queue.empty() && idle.load() == workers) cv.notify_all();
+                    cv.wait(lock, [&] { return stop.load() || !queue.empty() || idle.load() == workers; });
+                    if (stop.load() || queue.empty()) return;   // halted, or everyone idle with no work left
+                    task = std::move(queue.front());
+                    queue.pop_front();
+                    idle.fetch_sub(1);
+                }
+                dfs(task.s, task.depth, task.path);
+            }
+        }
+
+        void dfs(const State& cur, int depth, std::vector<TraceStep>& path) {
+            if (stop.load(std::memory_order_relaxed)) return;
+            if (!timeOk()) { timedOut.store(true); halt(); return; }
+
+            if (RuleEngine<Rules>::isSolved(cur)) {
+                if (depth <= depthLimit && count.fetch_add(1) + 1 >= maxCount) {
+                    limitHit.store(true);
+                    halt();
+                }
+                return;
+            }
+            if (depth + Solver::runLowerBound(cur) > depthLimit) return;
+
+            std::vector<std::pair<TraceStep, State>> children;
+            traceChildren<Rules>(cur, path, lockFree, children);
+
+            // Subtrees a move or two from the leaves are not worth the hand-off.
+            const bool canDonate = depth + 2 < depthLimit;
+            for (size_t k = 0; k < children.size(); ++k) {
+                auto& [step, next] = children[k];
+                if (!table.claim(next.hash(), depth + 1)) continue;
+                path.push_back(step);
+                if (canDonate && k + 1 < children.size() && idle.load(std::memory_order_relaxed) > 0) {
+                    {
+                        std::lock_guard<std::mutex> lock(m);
+                        queue.push_back(Task{ std::move(next), depth + 1, path });
+                    }
+                    cv.notify_one();
+                    path.pop_back();
+                    continue;
+                }
+                dfs(next, depth + 1, path);
+                path.pop_back();
+                if (stop.load(std::memory_order_relaxed)) return;
+            }
+        }
+    };
+
+    // Weighted A* on f = g + w * runLowerBound. The run bound is admissible and consistent (a
+    // pour changes one colour's run count by at most one), so the first solved state popped is
+    // at most w times optimal even though closed states are never re-opened.
+    template <class Rules>
+    static SolveResult solveWeighted(const State& start, double weight, const std::function<bool()>& timeOk, SolveTrace* trace) {
+        using Engine = RuleEngine<Rules>;
+        struct WeightedNode { State s; int g; int parent; Move m; };
+        struct Entry { double f; int g; int node; };
+        auto worse = [](const Entry& a, const Entry& b) { return a.f != b.f ? a.f > b.f : a.g < b.g; };
+
+        SolveResult result;
+        const int rootBound = Solver::runLowerBound(start);
+        std::vector<WeightedNode> nodes;
+        std::priority_queue<Entry, std::vector<Entry>, decltype(worse)> open(worse);
+        std::unordered_map<size_t, int> bestG;
+        std::unordered_set<size_t> closed;
+        nodes.push_back(WeightedNode{ start, 0, -1, Move{ -1, -1, 0 } });
+        open.push(Entry{ weight * rootBound, 0, 0 });
+        bestG[start.hash()] = 0;
+
+        int goal = -1;
+        size_t pops = 0;
+        const auto searchStart = std::chrono::steady_clock::now();
+        while (!open.empty()) {
+            if ((++pops & 255) == 0 && !timeOk()) { result.timedOut = true; break; }
+            const Entry e = open.top();
+            open.pop();
+            const size_t h = nodes[e.node].s.hash();
+            if (bestG[h] < e.g || !closed.insert(h).second) continue;
+            if (Engine::isSolved(nodes[e.node].s)) { goal = e.node; break; }
+
+            const State cur = nodes[e.node].s;
+            Engine::forEachMove(cur, [&](const Move& m) {
+                State next = cur;
+                Engine::apply(next, m);
+                const size_t hn = next.hash();
+                if (closed.count(hn)) return;
+                auto [it, fresh] = bestG.try_emplace(hn, e.g + 1);
+                if (!fresh) {
+                    if (it->second <= e.g + 1) return;
+                    it->second = e.g + 1;
+                }
+                const double f = e.g + 1 + weight * Solver::runLowerBound(next);
+                nodes.push_back(WeightedNode{ std::move(next), e.g + 1, e.node, m });
+                open.push(Entry{ f, e.g + 1, (int)nodes.size() - 1 });
+                });
+        }
+
+        if (trace) {
+            const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - searchStart).count();
+            trace->nodes = pops;
+            trace->peakTableEntries = bestG.size();
+            trace->peakTableBytes = bestG.size() * (sizeof(size_t) + sizeof(int) + 2 * sizeof(void*)) + bestG.bucket_count() * sizeof(void*);
+            trace->iterations.push_back(SolveTrace::Iteration{ rootBound, pops, bestG.size(), ms });
+            trace->searchMs = ms;
+        }
+        if (goal < 0) {
+            result.lowerBound = rootBound;
+            return result;
+        }
+        for (int n = goal; nodes[n].parent >= 0; n = nodes[n].parent) result.solutionMoves.push_back(nodes[n].m);
+        std::reverse(result.solutionMoves.begin(), result.solutionMoves.end());
+
+        const int found = (int)result.solutionMoves.size();
+        result.solved = true;
+        result.minMoves = found;
+        result.lowerBound = std::max(rootBound, (int)std::ceil(found / weight - 1e-9));
+        result.suboptimalityBound = result.lowerBound > 0 ? (double)found / result.lowerBound : 1.0;
+        result.distinctSolutions = 1;
+        return result;
+    }
+
+    // Easy-board pass: node cap (about 20 ms of packed search, past the 90th percentile of
+    // generated 8-bottle, 6-colour boards), depth and table size of the FixedSolver run.
+    constexpr uint64_t kEasyNodeLimit = 50000;
+    constexpr int kEasyMaxDepth = 64;
+    constexpr size_t kEasyTableEntries = 4096;
+
+    // Exact IDA* on the packed board in a per-thread block; false when it does not finish under
+    // the cap. `s` must pass isPackable().
+    static bool solveEasy(const State& s, std::vector<Move>& path) {
+        Params p = s.p;
+        p.numBottles = (int)s.B.size();
+        p.capacity = s.B[0].capacity;
+        thread_local std::vector<uint64_t> block;
+        const size_t bytes = FixedSolver::requiredBytes(p, kEasyMaxDepth, kEasyTableEntries);
+        if (block.size() * sizeof(uint64_t) < bytes) block.resize(bytes / sizeof(uint64_t) + 1);
+        FixedSolver fixed(block.data(), bytes, p, FixedSolveOptions{ kEasyNodeLimit, kEasyMaxDepth });
+        SolveResult out;
+        if (!fixed.solve(s, out) || !out.solved) return false;
+        path = std::move(out.solutionMoves);
+        return true;
+    }
+
+    // Solver settings past the budget and worker count, as the engine reads them.
+    struct SearchKnobs {
+        double weight{ 1.0 };
+        const MoveOrderModel* moveOrder{ nullptr };
+        SolverHeuristic heuristic{ SolverHeuristic::Fragmentation };
+        bool pruning{ true };
+        size_t tableLimit{ 0 };
+        SolveTrace* trace{ nullptr };
+    };
+
+    // The search proper, instantiated once per rule set so the hot loop calls the rules directly.
+    template <class Rules>
+    static SolveResult solveWithRules(const State& start, int budgetMs, int countWorkers, const SearchKnobs& knobs, const std::vector<Move>* known) {
+        using Engine = RuleEngine<Rules>;
         using clock = std::chrono::steady_clock;
         auto t0 = clock::now();
-        const State solveStart = normalizeForSolve(start);
+        const State solveStart = Solver::normalizeForSolve(start);
+        if (knobs.trace) *knobs.trace = SolveTrace{};
+
+        // Replay the known solution; amounts are recomputed since edits may have changed them.
+        std::vector<Move> knownPath;
+        int upperBound = std::numeric_limits<int>::max();
+        if (known && !known->empty()) {
+            State s = solveStart;
+            for (const auto& m : *known) {
+                int amt = 0;
+                if (!Engine::canPour(s, m.from, m.to, &amt)) break;
+                knownPath.push_back(Move{ m.from,m.to,amt });
+                Engine::apply(s, knownPath.back());
+            }
+            if (Engine::isSolved(s)) upperBound = (int)knownPath.size();
+            else knownPath.clear();
+        }
 
         SolveResult result;
         std::vector<Move> path;
         std::vector<Move> solutionMoves;
         bool foundPath = false;
 
-        if (solveStart.isSolved()) {
+        if (Engine::isSolved(solveStart)) {
             result.solved = true;
             result.minMoves = 0;
+            result.lowerBound = 0;
             result.distinctSolutions = 1;
             result.solutionCountExhaustive = true;
             return result;
         }
 
-        int bound = heuristic(solveStart);
-
+        const double weight = knobs.weight;
+        const MoveOrderModel* moveOrder = knobs.moveOrder;
+        SolveTrace* trace = knobs.trace;
         auto timeOk = [&] { return std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - t0).count() < budgetMs; };
+        if (weight > 1.0) {
+            const std::function<bool()> weightedTimeOk = timeOk;
+            return solveWeighted<Rules>(solveStart, weight, weightedTimeOk, trace);
+        }
+
+        // Gimmick-free boards go through the easy-board pass first: most Very Easy and Easy maps
+        // finish there with a proven optimum, and the rest fall through to the search below.
+        // Solver Lab configurations that change the search, or trace it, skip the pass.
+        bool provenDepth = knobs.heuristic == SolverHeuristic::RunBound && !knobs.pruning;
+        if (knobs.heuristic == SolverHeuristic::Fragmentation && knobs.pruning && !trace && isPackable(solveStart) &&
+            solveEasy(solveStart, solutionMoves)) {
+            result.solved = true;
+            provenDepth = true;
+        }
 
         // IDA* search
         std::unordered_set<size_t> visited;
         bool searchTimedOut = false;
-        int solvedDepth = -1;
+        int solvedDepth = result.solved ? (int)solutionMoves.size() : -1;
+
+        // When every bottle has a BottleTable code, each depth keeps the codes of its board: a
+        // child's are its parent's with the two poured bottles re-encoded, and the heuristic,
+        // goal test and pour checks below read table entries instead of walking slots.
+        const BottleTable* table = BottleTable::forState(solveStart);
+        std::deque<std::vector<uint32_t>> codeStack(1);
+        if (table && !table->encode(solveStart, codeStack[0])) table = nullptr;
+        auto estimate = [&](const State& s, const uint32_t* codes) {
+            if (knobs.heuristic == SolverHeuristic::RunBound) return Solver::runLowerBound(s);
+            return table ? heuristic(*table, codes, s.B.size()) : heuristic(s);
+        };
+        int bound = estimate(solveStart, table ? codeStack[0].data() : nullptr);
+        uint64_t nodes = 0;
 
-        std::function<int(const State&, int, int)> dfs = [&](const State& s, int g, int boundVal) {
+        std::function<int(const State&, const uint32_t*, int, int)> dfs = [&](const State& s, const uint32_t* codes, int g, int boundVal) {
             if (!timeOk()) { searchTimedOut = true; return std::numeric_limits<int>::max(); }
 
-            int f = g + heuristic(s);
+            ++nodes;
+            int f = g + estimate(s, codes);
             if (f > boundVal) return f;
-            if (s.isSolved()) {
+            if (table ? Engine::isSolved(s, *table, codes) : Engine::isSolved(s)) {
                 if (!foundPath) {
                     solutionMoves = path;
                     foundPath = true;
@@ -147,27 +537,45 @@ namespace ws {
                 return -g; // found, return negative depth
             }
 
-            size_t h = s.hash();
-            if (visited.count(h)) return std::numeric_limits<int>::max();
-            visited.insert(h);
+            if (knobs.pruning) {
+                size_t h = s.hash();
+                if (visited.count(h)) return std::numeric_limits<int>::max();
+                if (knobs.tableLimit == 0 || visited.size() < knobs.tableLimit) visited.insert(h);
+            }
 
             int minNext = std::numeric_limits<int>::max();
-            // move ordering: try pours that match color first
-            struct Cand { Move m; bool prefer; };
+            // move ordering: the learned model's score when one is set, else pours that match color first
+            struct Cand { Move m; float prefer; };
             std::vector<Cand> cand;
+            MoveOrderModel::Context ctx;
+            if (moveOrder) ctx = MoveOrderModel::context(s);
             for (int i = 0; i < (int)s.B.size(); ++i) {
                 for (int j = 0; j < (int)s.B.size(); ++j) {
-                    if (i == j) continue; int amt = 0; if (!s.canPour(i, j, &amt)) continue;
-                    bool prefer = !s.B[j].isEmpty() && s.B[i].topColor() == s.B[j].topColor();
-                    cand.push_back({ Move{i,j,amt},prefer });
+                    if (i == j) continue;
+                    int amt = 0;
+                    if (table ? !Engine::canPour(s, i, j, (*table)[codes[i]], (*table)[codes[j]], &amt) : !Engine::canPour(s, i, j, &amt)) continue;
+                    const Move m{ i,j,amt };
+                    float prefer = 0.0f;
+                    if (moveOrder) prefer = moveOrder->score(s, ctx, m);
+                    else prefer = (!s.B[j].isEmpty() && s.B[i].topColor() == s.B[j].topColor()) ? 1.0f : 0.0f;
+                    cand.push_back({ m,prefer });
                 }
             }
             std::stable_sort(cand.begin(), cand.end(), [](const Cand& a, const Cand& b) {return a.prefer > b.prefer; });
 
             for (const auto& c : cand) {
-                State s2 = s; s2.apply(c.m);
+                State s2 = s; Engine::apply(s2, c.m);
+                const uint32_t* childCodes = nullptr;
+                if (table) {
+                    if ((int)codeStack.size() <= g + 1) codeStack.emplace_back();
+                    auto& next = codeStack[(size_t)g + 1];
+                    next.assign(codes, codes + s.B.size());
+                    next[(size_t)c.m.from] = table->code(s2.B[c.m.from]);
+                    next[(size_t)c.m.to] = table->code(s2.B[c.m.to]);
+                    childCodes = next.data();
+                }
                 path.push_back(c.m);
-                int t = dfs(s2, g + 1, boundVal);
+                int t = dfs(s2, childCodes, g + 1, boundVal);
                 if (!path.empty()) path.pop_back();
                 if (t < 0) return t; // solved at depth g'
                 if (t < minNext) minNext = t;
@@ -176,29 +584,69 @@ namespace ws {
             return minNext;
         };
 
-        while (true) {
+        bool boundReached = false;
+        bool exhausted = false;
+        while (!result.solved) {
             if (!timeOk()) { searchTimedOut = true; break; }
+            if (bound >= upperBound) { boundReached = true; break; }
             visited.clear();
-            int t = dfs(solveStart, 0, bound);
+            const auto iterStart = clock::now();
+            const uint64_t nodesBefore = nodes;
+            int t = dfs(solveStart, table ? codeStack[0].data() : nullptr, 0, bound);
+            if (trace) {
+                const size_t bytes = visited.size() * (sizeof(size_t) + sizeof(void*)) + visited.bucket_count() * sizeof(void*);
+                trace->iterations.push_back(SolveTrace::Iteration{ bound, nodes - nodesBefore, visited.size(),
+                    std::chrono::duration<double, std::milli>(clock::now() - iterStart).count() });
+                trace->peakTableEntries = std::max(trace->peakTableEntries, visited.size());
+                trace->peakTableBytes = std::max(trace->peakTableBytes, bytes);
+            }
             if (t < 0) {
                 solvedDepth = -t;
                 result.solved = true;
                 break;
             }
             if (searchTimedOut || t == std::numeric_limits<int>::max()) {
+                exhausted = !searchTimedOut;
                 searchTimedOut = true;
                 break;
             }
             bound = t;
         }
+        if (trace) {
+            trace->nodes = nodes;
+            trace->searchMs = std::chrono::duration<double, std::milli>(clock::now() - t0).count();
+        }
+
+        if (!result.solved && !knownPath.empty() && boundReached) {
+            // No shorter line turned up below the known length: the known path is the answer.
+            solvedDepth = upperBound;
+            solutionMoves = std::move(knownPath);
+            result.solved = true;
+        }
+        else if (!result.solved && !knownPath.empty()) {
+            // Timed out, or exhausted: running out of nodes while a known solution exists means
+            // the visited set cut real solutions off, so nothing below the known length is proven.
+            result.timedOut = !exhausted;
+            result.minMoves = upperBound;
+            result.lowerBound = Solver::runLowerBound(solveStart);
+            result.solutionMoves = std::move(knownPath);
+            return result;
+        }
 
         if (!result.solved) {
+            // `bound` is not proven unless the heuristic is admissible and nothing pruned
+            // across depths; otherwise fall back to the run bound.
             result.timedOut = searchTimedOut;
             result.minMoves = bound;
+            result.lowerBound = Solver::runLowerBound(solveStart);
+            if (knobs.heuristic == SolverHeuristic::RunBound && !knobs.pruning) result.lowerBound = std::max(result.lowerBound, bound);
             return result;
         }
 
+        // Only an admissible, unpruned IDA* (or the easy-board pass) proves its first solution depth
+        // optimal; the default fragmentation heuristic and the visited set can both skip shorter lines.
         result.minMoves = solvedDepth;
+        result.lowerBound = provenDepth ? solvedDepth : Solver::runLowerBound(solveStart);
         result.solutionMoves = std::move(solutionMoves);
         result.distinctSolutions = 1;
 
@@ -207,14 +655,19 @@ namespace ws {
             return result;
         }
 
+        const auto countStart = clock::now();
         const int solutionSampleLimit = 4;
-        auto countStats = countMinimalSolutions(solveStart, solvedDepth, solutionSampleLimit, timeOk);
+        const std::function<bool()> countTimeOk = timeOk;
+        auto countStats = countWorkers > 1
+            ? ParallelSolutionCounter<Rules>(solvedDepth, solutionSampleLimit, countWorkers, countTimeOk).run(solveStart)
+            : countMinimalSolutions<Rules>(solveStart, solvedDepth, solutionSampleLimit, countTimeOk);
         if (countStats.timedOut) {
             result.timedOut = true;
         }
         if (countStats.count > 0) {
             result.distinctSolutions = countStats.count;
         }
+        if (trace) trace->countMs = std::chrono::duration<double, std::milli>(clock::now() - countStart).count();
         result.solutionCountExhaustive = countStats.exhaustive;
         result.solutionCountLimited = countStats.limitHit;
         if (!result.solutionCountExhaustive) {
@@ -228,6 +681,16 @@ namespace ws {
         return result;
     }
 
+    SolveResult Solver::solve(const State& start) {
+        const SearchKnobs knobs{ weight, moveOrder, heuristicKind, pruning, tableLimit, trace };
+        return rules::dispatch(start.p.ruleSet, [&](auto r) { return solveWithRules<decltype(r)>(start, budgetMs, countWorkers, knobs, nullptr); });
+    }
+
+    SolveResult Solver::solve(const State& start, const std::vector<Move>& knownSolution) {
+        const SearchKnobs knobs{ weight, moveOrder, heuristicKind, pruning, tableLimit, trace };
+        return rules::dispatch(start.p.ruleSet, [&](auto r) { return solveWithRules<decltype(r)>(start, budgetMs, countWorkers, knobs, &knownSolution); });
+    }
+
     double Solver::estimateDifficulty(const State& s, SolveResult& solveStats) const {
         const int minMoves = solveStats.minMoves;
         // Compose from heuristic features with softer contribution from gimmicks.
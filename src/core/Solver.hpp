@@ -1,6 +1,7 @@
 // ========================= src/core/Solver.hpp =========================
 #pragma once
 #include "State.hpp"
+#include <algorithm>
 #include <optional>
 
 namespace ws {
@@ -8,8 +9,10 @@ namespace ws {
     struct SolveResult {
         bool solved{ false };
         bool timedOut{ false };
-        int minMoves{ -1 };              // best-known optimal move count (exact when solved==true)
-        int distinctSolutions{ 0 };      // number of distinct optimal solutions discovered (capped)
+        int minMoves{ -1 };              // length of the best solution found (solved==true) or of the last bound
+        int lowerBound{ -1 };            // proven lower bound on the optimum; minMoves is exact only when equal
+        double suboptimalityBound{ 1.0 }; // minMoves <= this * optimum; above 1 only for a weighted solve
+        int distinctSolutions{ 0 };      // distinct optimal solutions discovered, reorderings of independent pours counted once (capped)
         bool solutionCountExhaustive{ false }; // true if the optimal-solution count search finished exhaustively
         bool solutionCountLimited{ false };    // true if counting stopped after hitting the sampling cap
         std::vector<Move> solutionMoves; // one optimal solution path (may be empty if unsolved)
@@ -28,13 +31,77 @@ namespace ws {
         } difficulty;
     };
 
+    struct MoveOrderModel;
+
+    // IDA* cost-to-go estimate. Fragmentation is the default and prunes hardest but is not
+    // admissible; RunBound is Solver::runLowerBound, admissible and weaker.
+    enum class SolverHeuristic : uint8_t { Fragmentation = 0, RunBound = 1 };
+    constexpr int kSolverHeuristicCount = 2;
+
+    inline const char* solverHeuristicName(SolverHeuristic h) {
+        return h == SolverHeuristic::RunBound ? "Run bound" : "Fragmentation";
+    }
+
+    // Search counters, filled when a trace is attached with Solver::setTrace.
+    struct SolveTrace {
+        struct Iteration {
+            int bound{ 0 };             // IDA* f bound (weighted A*: the root's f)
+            uint64_t nodes{ 0 };        // states entered at this bound
+            size_t tableEntries{ 0 };   // transposition entries when the iteration ended
+            double ms{ 0.0 };
+        };
+        std::vector<Iteration> iterations;
+        uint64_t nodes{ 0 };            // search nodes, solution counting excluded
+        size_t peakTableEntries{ 0 };
+        size_t peakTableBytes{ 0 };     // entries plus buckets of the transposition set, estimated
+        double searchMs{ 0.0 };
+        double countMs{ 0.0 };          // optimal-solution count after the search
+    };
+
     class Solver {
     public:
-        explicit Solver(int timeBudgetMs = 2000) :budgetMs(timeBudgetMs) {}
+        // countWorkers > 1 spreads the optimal-solution count after a successful search over
+        // that many threads; the search itself stays single-threaded.
+        // weight > 1 swaps IDA* for weighted A* (f = g + weight * h): minMoves is then within
+        // `weight` of optimal, lowerBound and suboptimalityBound say how close it is proven to be,
+        // no solutions are counted and a known solution is not used.
+        explicit Solver(int timeBudgetMs = 2000, int countWorkers = 1, double weight = 1.0)
+            :budgetMs(timeBudgetMs), countWorkers(std::max(1, countWorkers)), weight(std::max(1.0, weight)) {}
         SolveResult solve(const State& start);
+        // Same search with a known solution as an upper bound: moves are replayed on `start` and, if
+        // they still solve it, IDA* stops as soon as its bound reaches that length and returns them.
+        // A search that times out, or exhausts its pruned tree without reaching that bound, still
+        // reports the replayed path as an upper bound (solved == false, lowerBound from the runs).
+        SolveResult solve(const State& start, const std::vector<Move>& knownSolution);
         double estimateDifficulty(const State& s, SolveResult& solveStats) const;
+        // Orders IDA* children by a learned model instead of colour-match-first. The model is
+        // borrowed and must outlive the solves; nullptr restores the default order. With pruning
+        // on, which states the visited set cuts depends on this order, and so can minMoves.
+        Solver& setMoveOrder(const MoveOrderModel* model) { moveOrder = model; return *this; }
+        // IDA* knobs: heuristic, the transposition set on or off, and a cap on its entries
+        // (0 = unbounded; once full, new states are searched but not remembered).
+        Solver& setHeuristic(SolverHeuristic h) { heuristicKind = h; return *this; }
+        Solver& setPruning(bool on) { pruning = on; return *this; }
+        Solver& setTableLimit(size_t entries) { tableLimit = entries; return *this; }
+        // Borrowed; cleared and filled by every solve until reset to nullptr.
+        Solver& setTrace(SolveTrace* out) { trace = out; return *this; }
+
+        // Copy of the input with every '?' revealed; all engines search on this form.
+        static State normalizeForSolve(const State& input);
+        // Admissible move bound from surplus colour runs; cheap enough to call per node.
+        static int runLowerBound(const State& s);
+        // One bottle's share of the IDA* heuristic: the heuristic is the sum of these minus one
+        // per empty bottle (at most two). Exposed so callers can keep it incrementally.
+        static int heuristicTerm(const Bottle& b);
     private:
         int budgetMs{ 2000 };
+        int countWorkers{ 1 };
+        double weight{ 1.0 };
+        const MoveOrderModel* moveOrder{ nullptr };
+        SolverHeuristic heuristicKind{ SolverHeuristic::Fragmentation };
+        bool pruning{ true };
+        size_t tableLimit{ 0 };
+        SolveTrace* trace{ nullptr };
     };
 
 } // namespace ws
@@ -1,26 +1,96 @@
 ﻿// ========================= src/core/State.cpp =========================
 #include "State.hpp"
+#include "Rules.hpp"
 #include <random>
 #include <numeric>
+#include <algorithm>
 
 namespace ws {
 
-    static void revealHiddenChainBelowIfSameColor(Bottle& bottle, int openedIndex) {
-        if (openedIndex < 0 || openedIndex >= (int)bottle.slots.size()) return;
-        int idx = openedIndex;
-        while (idx - 1 >= 0) {
-            auto& upper = bottle.slots[idx];
-            auto& lower = bottle.slots[idx - 1];
-            if (!lower.hidden) break;
-            if (lower.c != upper.c) break;
-            lower.hidden = false;
-            --idx;
+    static uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+    void RNG::seed(uint64_t seedValue) {
+        uint64_t x = seedValue;
+        for (auto& w : s) {
+            uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            w = z ^ (z >> 31);
         }
+        hasSpare = false;
     }
 
-    static uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
-    uint64_t RNG::next() { s ^= rotl(s, 7); s ^= (s >> 9); return s * 0x9E3779B97F4A7C15ULL; }
-    int RNG::irange(int lo, int hi) { return lo + int(next() % uint64_t(hi - lo + 1)); }
+    RNG RNG::forStream(uint64_t seedValue, uint64_t stream) {
+        RNG r(seedValue);
+        for (uint64_t k = 0; k < stream; ++k) r.jump();
+        return r;
+    }
+
+    uint64_t RNG::next() {
+        const uint64_t result = rotl(s[1] * 5, 7) * 9;
+        const uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    uint32_t RNG::next32() {
+        if (hasSpare) {
+            hasSpare = false;
+            return (uint32_t)spare;
+        }
+        const uint64_t v = next();
+        spare = v >> 32;
+        hasSpare = true;
+        return (uint32_t)v;
+    }
+
+    uint32_t RNG::below(uint32_t bound) {
+        if (bound == 0) return 0;
+        uint64_t m = (uint64_t)next32() * bound;
+        uint32_t low = (uint32_t)m;
+        if (low < bound) {
+            const uint32_t threshold = (0u - bound) % bound;
+            while (low < threshold) {
+                m = (uint64_t)next32() * bound;
+                low = (uint32_t)m;
+            }
+        }
+        return (uint32_t)(m >> 32);
+    }
+
+    int RNG::irange(int lo, int hi) {
+        if (hi <= lo) return lo;
+        const uint32_t span = (uint32_t)((int64_t)hi - lo + 1);
+        return (int)((int64_t)lo + (span ? below(span) : next32()));
+    }
+
+    void RNG::jump() {
+        static const uint64_t kJump[4] = { 0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL, 0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL };
+        uint64_t t[4] = { 0, 0, 0, 0 };
+        for (uint64_t word : kJump) {
+            for (int b = 0; b < 64; ++b) {
+                if (word & (uint64_t(1) << b)) {
+                    for (int i = 0; i < 4; ++i) t[i] ^= s[i];
+                }
+                next();
+            }
+        }
+        for (int i = 0; i < 4; ++i) s[i] = t[i];
+        hasSpare = false;
+    }
+
+    void RNG::fill(uint64_t* out, size_t n) {
+        for (size_t i = 0; i < n; ++i) out[i] = next();
+    }
+
+    void RNG::fillBelow(uint32_t* out, size_t n, uint32_t bound) {
+        for (size_t i = 0; i < n; ++i) out[i] = below(bound);
+    }
 
     State State::goal(const Params& p) {
         State st; st.p = p; st.B.resize(p.numBottles);
@@ -35,127 +105,21 @@ namespace ws {
         return st;
     }
 
+    // Rule logic lives in RuleEngine (Rules.hpp); these pick the instantiation for p.ruleSet.
     void State::refreshLocks() {
-        locks.bushLocked.assign(B.size(), false);
-        locks.clothLocked.assign(B.size(), false);
-
-        // Precompute which colors are already completed in some bottle
-        std::array<bool, 21> colorCompleted{}; // colors 1..20
-        colorCompleted.fill(false);
-        for (size_t i = 0; i < B.size(); ++i) {
-            if (B[i].isMonoFull()) colorCompleted[B[i].slots[0].c] = true;
-        }
-
-        for (size_t i = 0; i < B.size(); ++i) {
-            const auto& g = B[i].gimmick;
-            if (g.kind == StackGimmickKind::Cloth) {
-                if (g.clothTarget >= 1 && g.clothTarget <= 20) {
-                    locks.clothLocked[i] = !colorCompleted[g.clothTarget];
-                }
-            }
-            else if (g.kind == StackGimmickKind::Bush) {
-                bool leftOk = (i > 0 && B[i - 1].isMonoFull());
-                bool rightOk = (i + 1 < B.size() && B[i + 1].isMonoFull());
-                locks.bushLocked[i] = !(leftOk || rightOk);
-            }
-        }
+        rules::dispatch(p.ruleSet, [&](auto r) { RuleEngine<decltype(r)>::refreshLocks(*this); });
     }
 
     bool State::canPour(int from, int to, int* outAmount) const {
-        if (from == to || from < 0 || to < 0 || from >= (int)B.size() || to >= (int)B.size()) return false;
-        const auto& bf = B[from];
-        const auto& bt = B[to];
-
-        // Vine: cannot pour OUT of a vine bottle
-        if (bf.gimmick.kind == StackGimmickKind::Vine) return false;
-
-        // Cloth / Bush: if locked, cannot use this bottle at all (no in/out)
-        if ((B[from].gimmick.kind == StackGimmickKind::Cloth && locks.clothLocked[from]) ||
-            (B[from].gimmick.kind == StackGimmickKind::Bush && locks.bushLocked[from])) return false;
-        if ((B[to].gimmick.kind == StackGimmickKind::Cloth && locks.clothLocked[to]) ||
-            (B[to].gimmick.kind == StackGimmickKind::Bush && locks.bushLocked[to])) return false;
-
-        if (bf.slots.empty()) return false;
-        if (bt.size() >= bt.capacity) return false;
-
-        Color tcol = bf.topColor();
-        if (tcol == 0) return false;
-
-        // '?' reveal rule: color reveals when it becomes the top (already true here)
-        // (No special restriction for moving; UI may hide it from the player.)
-
-        Color destTop = bt.topColor();
-        if (destTop != 0 && destTop != tcol) return false;
-
-        int chunk = bf.topChunk();
-        int free = bt.capacity - bt.size();
-        int mv = std::min(chunk, free);
-        if (mv <= 0) return false;
-        if (outAmount) *outAmount = mv;
-        return true;
+        return rules::dispatch(p.ruleSet, [&](auto r) { return RuleEngine<decltype(r)>::canPour(*this, from, to, outAmount); });
     }
 
     void State::apply(const Move& m) {
-        if (m.from < 0 || m.to < 0) return;
-        auto& f = B[m.from];
-        auto& t = B[m.to];
-        int amount = m.amount;
-        if (amount <= 0) {
-            int calc = 0; if (!canPour(m.from, m.to, &calc)) return; amount = calc;
-        }
-        Color col = f.topColor();
-        for (int i = 0; i < amount; ++i) {
-            auto s = f.slots.back();
-            const bool wasHidden = s.hidden;
-            s.hidden = false; // when leaving source top, it’s revealed already
-            t.slots.push_back(s);
-            if (wasHidden) {
-                revealHiddenChainBelowIfSameColor(t, (int)t.slots.size() - 1);
-            }
-            f.slots.pop_back();
-        }
-        // After move, revealing rule: if new top of any bottle has hidden=true and is now at top, it becomes visible
-        if (!f.slots.empty() && f.slots.back().hidden) {
-            f.slots.back().hidden = false;
-            revealHiddenChainBelowIfSameColor(f, (int)f.slots.size() - 1);
-        }
-        if (!t.slots.empty() && t.slots.back().hidden) {
-            t.slots.back().hidden = false;
-            revealHiddenChainBelowIfSameColor(t, (int)t.slots.size() - 1);
-        }
-
-        // update locks (mono full may have changed)
-        refreshLocks();
+        rules::dispatch(p.ruleSet, [&](auto r) { RuleEngine<decltype(r)>::apply(*this, m); });
     }
 
     bool State::isSolved() const {
-        for (const auto& b : B) {
-            if (!b.slots.empty() && !b.isMonoFull()) return false;
-            for (const auto& s : b.slots) {
-                if (s.hidden) return false;
-            }
-        }
-
-        // Perfect clear policy: all gimmick locks must be released.
-        std::array<bool, 21> colorCompleted{}; // colors 1..20
-        colorCompleted.fill(false);
-        for (const auto& b : B) {
-            if (b.isMonoFull()) colorCompleted[b.slots[0].c] = true;
-        }
-
-        for (size_t i = 0; i < B.size(); ++i) {
-            const auto& g = B[i].gimmick;
-            if (g.kind == StackGimmickKind::Cloth) {
-                if (!(g.clothTarget >= 1 && g.clothTarget <= 20 && colorCompleted[g.clothTarget])) return false;
-            }
-            else if (g.kind == StackGimmickKind::Bush) {
-                bool leftOk = (i > 0 && B[i - 1].isMonoFull());
-                bool rightOk = (i + 1 < B.size() && B[i + 1].isMonoFull());
-                if (!(leftOk || rightOk)) return false;
-            }
-        }
-
-        return true;
+        return rules::dispatch(p.ruleSet, [&](auto r) { return RuleEngine<decltype(r)>::isSolved(*this); });
     }
 
     size_t State::hash() const {
@@ -169,9 +133,76 @@ namespace ws {
             }
             // gimmick
             h ^= (uint64_t)b.gimmick.kind;
-            h ^= (uint64_t)(b.gimmick.clothTarget << 32);
+            h ^= (uint64_t)b.gimmick.clothTarget << 32;
         }
         return size_t(h);
     }
 
+    static uint64_t mix64(uint64_t x) {
+        x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ull;
+        x ^= x >> 27; x *= 0x94d049bb133111ebull;
+        x ^= x >> 31;
+        return x;
+    }
+
+    static uint64_t bottleContentHash(const Bottle& b) {
+        uint64_t h = 0xcbf29ce484222325ull ^ uint64_t(b.capacity);
+        for (const auto& s : b.slots) {
+            h ^= (uint64_t(s.c) << 1) | (s.hidden ? 1ull : 0ull);
+            h *= 0x100000001b3ull;
+        }
+        h ^= uint64_t(b.slots.size()) << 56;
+        return mix64(h);
+    }
+
+    bool State::isInterchangeable(int i) const {
+        if (i < 0 || i >= (int)B.size()) return false;
+        if (B[i].gimmick.kind != StackGimmickKind::None) return false;
+        if (i > 0 && B[i - 1].gimmick.kind == StackGimmickKind::Bush) return false;
+        if (i + 1 < (int)B.size() && B[i + 1].gimmick.kind == StackGimmickKind::Bush) return false;
+        return true;
+    }
+
+    uint64_t State::canonicalHash() const {
+        uint64_t h = mix64(uint64_t(p.numColors) | (uint64_t(p.numBottles) << 16) | (uint64_t(p.capacity) << 32));
+
+        // Pinned bottles (gimmicks and Bush neighbours) hash by position; the rest as a sorted multiset.
+        std::array<uint64_t, 64> freeBuf{};
+        std::vector<uint64_t> freeOverflow;
+        size_t freeCount = 0;
+        for (size_t i = 0; i < B.size(); ++i) {
+            const uint64_t bh = bottleContentHash(B[i]);
+            if (isInterchangeable((int)i)) {
+                if (freeCount < freeBuf.size()) freeBuf[freeCount] = bh;
+                else freeOverflow.push_back(bh);
+                ++freeCount;
+                continue;
+            }
+            const auto& g = B[i].gimmick;
+            uint64_t pinned = bh ^ mix64((uint64_t(i) << 16) | (uint64_t(g.kind) << 8) | uint64_t(g.clothTarget));
+            h = mix64(h ^ pinned);
+        }
+
+        if (freeOverflow.empty()) {
+            std::sort(freeBuf.begin(), freeBuf.begin() + freeCount);
+            for (size_t i = 0; i < freeCount; ++i) h = mix64(h + freeBuf[i]);
+        }
+        else {
+            freeOverflow.insert(freeOverflow.end(), freeBuf.begin(), freeBuf.end());
+            std::sort(freeOverflow.begin(), freeOverflow.end());
+            for (uint64_t v : freeOverflow) h = mix64(h + v);
+        }
+        return h;
+    }
+
+    uint64_t State::fingerprint() const {
+        // FNV-1a over one length byte plus the colour bytes of each bottle, then a final mix.
+        uint64_t h = 0xcbf29ce484222325ull;
+        for (const auto& b : B) {
+            h = (h ^ uint64_t(b.slots.size())) * 0x100000001b3ull;
+            for (const auto& s : b.slots) h = (h ^ uint64_t(s.c)) * 0x100000001b3ull;
+        }
+        return mix64(h);
+    }
+
 } // namespace ws
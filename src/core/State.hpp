@@ -1,7 +1,10 @@
 ﻿// ========================= src/core/State.hpp =========================
 #pragma once
 #include "Types.hpp"
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <utility>
 #include <unordered_set>
 #include <unordered_map>
 #include <chrono>
@@ -36,8 +39,53 @@ namespace ws {
 
         // util
         size_t hash() const; // Zobrist‑style cheap hash
+
+        // Bottles without a gimmick that are not next to a Bush can be swapped freely
+        // (same capacity) without changing which moves are legal.
+        bool isInterchangeable(int i) const;
+        // Platform-stable 64-bit hash that is invariant under permutations of interchangeable bottles.
+        uint64_t canonicalHash() const;
+        // Platform-stable positional hash of colours only ('?' flags ignored), so a client can
+        // key its true board without knowing what the player has revealed.
+        uint64_t fingerprint() const;
     };
 
-    struct RNG { uint64_t s = 0x9E3779B97F4A7C15ULL; uint64_t next(); int irange(int lo, int hi); };
+    // xoshiro256** seeded through splitmix64. jump() advances 2^128 draws, so forStream(seed, k)
+    // gives each parallel worker a non-overlapping stream that is reproducible from (seed, k).
+    // Bounded draws use Lemire's multiply-shift with rejection (no modulo bias) on 32-bit halves,
+    // so one 64-bit step serves two draws on the shuffle and scramble hot paths.
+    struct RNG {
+        uint64_t s[4]{};
+
+        RNG() { seed(0x9E3779B97F4A7C15ULL); }
+        explicit RNG(uint64_t seedValue) { seed(seedValue); }
+        static RNG forStream(uint64_t seedValue, uint64_t stream);
+
+        void seed(uint64_t seedValue);
+        uint64_t next();
+        uint32_t next32();
+        uint32_t below(uint32_t bound);   // uniform in [0, bound); 0 when bound == 0
+        int irange(int lo, int hi);       // uniform in [lo, hi]; lo when hi <= lo
+        void jump();
+
+        // Bulk draws: raw 64-bit words, or values uniform in [0, bound).
+        void fill(uint64_t* out, size_t n);
+        void fillBelow(uint32_t* out, size_t n, uint32_t bound);
+
+        // Unbiased Fisher-Yates.
+        template <class It>
+        void shuffle(It first, It last) {
+            for (auto i = last - first; i > 1; --i) {
+                const auto j = below((uint32_t)i);
+                if ((decltype(i))j != i - 1) std::swap(first[i - 1], first[j]);
+            }
+        }
+        template <class Container>
+        void shuffle(Container& c) { shuffle(c.begin(), c.end()); }
+
+    private:
+        uint64_t spare{ 0 };
+        bool hasSpare{ false };
+    };
 
 } // namespace ws
\ No newline at end of file
@@ -0,0 +1,216 @@
+// ========================= src/core/TemplateOptimizer.cpp =========================
+#include "TemplateOptimizer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
+namespace ws {
+
+    namespace {
+
+        uint64_t mix(uint64_t h, uint64_t v) {
+            h ^= v + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+            return h * 0xBF58476D1CE4E5B9ULL;
+        }
+
+        int bandIndex(const std::string& label) {
+            static const char* order[] = { "Very Easy", "Easy", "Normal", "Hard", "Very Hard" };
+            for (int i = 0; i < 5; ++i) if (label == order[i]) return i;
+            return -1;
+        }
+
+        enum class Mutation { Height, GimmickSwap, ClothTarget, Hidden };
+
+        // One random edit of `s` of the given kind; false when the layout has nothing to move.
+        bool mutate(State& s, Mutation kind, int numColors, RNG& rng) {
+            const int n = (int)s.B.size();
+            if (n < 2) return false;
+            switch (kind) {
+            case Mutation::Height: {
+                std::vector<int> from, to;
+                for (int i = 0; i < n; ++i) {
+                    if (!s.B[i].isEmpty()) from.push_back(i);
+                    if (!s.B[i].isFull()) to.push_back(i);
+                }
+                if (from.empty() || to.empty()) return false;
+                const int i = from[rng.below((uint32_t)from.size())];
+                const int j = to[rng.below((uint32_t)to.size())];
+                if (i == j) return false;
+                // The cell keeps its '?' flag so the hidden count stays put.
+                const bool hidden = s.B[i].slots.back().hidden;
+                s.B[i].slots.pop_back();
+                s.B[j].slots.push_back(Slot{ 1, hidden });
+                return true;
+            }
+            case Mutation::GimmickSwap: {
+                const int i = (int)rng.below((uint32_t)n);
+                const int j = (int)rng.below((uint32_t)n);
+                const auto& a = s.B[i].gimmick;
+                const auto& b = s.B[j].gimmick;
+                if (a.kind == b.kind && a.clothTarget == b.clothTarget) return false;
+                std::swap(s.B[i].gimmick, s.B[j].gimmick);
+                return true;
+            }
+            case Mutation::ClothTarget: {
+                std::vector<int> cloth;
+                for (int i = 0; i < n; ++i) if (s.B[i].gimmick.kind == StackGimmickKind::Cloth) cloth.push_back(i);
+                if (cloth.empty() || numColors < 2) return false;
+                auto& g = s.B[cloth[rng.below((uint32_t)cloth.size())]].gimmick;
+                const Color next = (Color)(1 + rng.below((uint32_t)numColors));
+                if (next == g.clothTarget) return false;
+                g.clothTarget = next;
+                return true;
+            }
+            case Mutation::Hidden: {
+                std::vector<std::pair<int, int>> shown, hidden;
+                for (int i = 0; i < n; ++i) {
+                    for (int k = 0; k < s.B[i].size(); ++k) (s.B[i].slots[k].hidden ? hidden : shown).emplace_back(i, k);
+                }
+                if (shown.empty() || hidden.empty()) return false;
+                const auto [hi, hk] = hidden[rng.below((uint32_t)hidden.size())];
+                const auto [si, sk] = shown[rng.below((uint32_t)shown.size())];
+                s.B[hi].slots[hk].hidden = false;
+                s.B[si].slots[sk].hidden = true;
+                return true;
+            }
+            }
+            return false;
+        }
+
+    } // namespace
+
+    uint64_t layoutKey(const State& layout) {
+        uint64_t h = mix(0, layout.B.size());
+        for (const auto& b : layout.B) {
+            h = mix(h, (uint64_t)b.size() | (uint64_t)b.capacity << 16 | (uint64_t)b.gimmick.kind << 32 | (uint64_t)b.gimmick.clothTarget << 40);
+            uint64_t hidden = 0;
+            for (int k = 0; k < b.size() && k < 64; ++k) hidden |= (uint64_t)(b.slots[k].hidden ? 1 : 0) << k;
+            h = mix(h, hidden);
+        }
+        return h;
+    }
+
+    bool betterLayout(const LayoutCandidate& a, const LayoutCandidate& b) {
+        if ((a.inBand > 0) != (b.inBand > 0)) return a.inBand > 0;
+        if (a.inBand > 0 && a.msPerTarget != b.msPerTarget) return a.msPerTarget < b.msPerTarget;
+        if (a.inBand == 0 && a.bandDistance != b.bandDistance) return a.bandDistance < b.bandDistance;
+        if (a.accepted * b.attempts != b.accepted * a.attempts) return a.accepted * b.attempts > b.accepted * a.attempts;
+        return a.msPerAttempt < b.msPerAttempt;
+    }
+
+    LayoutSearchResult optimizeTemplateLayout(const Params& p, const GenOptions& gen, const State& seed,
+        const LayoutSearchOptions& opt, std::atomic<bool>* cancel,
+        const std::function<void(const LayoutCandidate&, int)>& onImproved) {
+        using clock = std::chrono::steady_clock;
+        const auto t0 = clock::now();
+        auto elapsedMs = [&] { return std::chrono::duration<double, std::milli>(clock::now() - t0).count(); };
+        LayoutSearchResult res;
+        auto stopped = [&] {
+            if (cancel && cancel->load()) res.cancelled = true;
+            return res.cancelled || elapsedMs() >= opt.timeBudgetMs || res.evaluated >= opt.maxLayouts;
+        };
+
+        // Without startMixed the generator starts from the goal board and ignores template heights.
+        std::vector<Mutation> kinds;
+        if (opt.moveHeights && gen.startMixed) kinds.push_back(Mutation::Height);
+        if (opt.moveGimmicks) { kinds.push_back(Mutation::GimmickSwap); kinds.push_back(Mutation::ClothTarget); }
+        if (opt.moveHidden) kinds.push_back(Mutation::Hidden);
+        RNG rng(opt.seed);
+        auto propose = [&](State s, int edits) {
+            for (int e = 0, tries = 0; e < edits && tries < 16 * edits && !kinds.empty(); ++tries) {
+                if (mutate(s, kinds[rng.below((uint32_t)kinds.size())], p.numColors, rng)) ++e;
+            }
+            return s;
+        };
+
+        // Fixed sample size: targetHalfWidth < 0 keeps the estimator from stopping early.
+        DryRunOptions dry;
+        dry.minSamples = dry.maxSamples = std::max(1, opt.samplesPerLayout);
+        dry.targetHalfWidth = -1.0;
+        dry.budgetScale = opt.budgetScale;
+        dry.workers = std::max(1, opt.workers);
+        DryRunTemplate source;
+        source.kind = DryRunTemplate::Kind::Fixed;
+
+        const int target = bandIndex(opt.targetBand);
+        std::unordered_map<uint64_t, LayoutCandidate> cache;
+        auto evaluate = [&](const State& layout) -> const LayoutCandidate* {
+            const uint64_t key = layoutKey(layout);
+            if (auto it = cache.find(key); it != cache.end()) {
+                ++res.cacheHits;
+                return &it->second;
+            }
+            source.fixed = layout;
+            dry.timeBudgetMs = std::max(1, opt.timeBudgetMs - (int)elapsedMs());
+            const auto est = estimateTemplateYield(p, gen, source, dry, cancel);
+            // A sample cut short by the budget or a cancel would be scored on too few attempts.
+            if (est.attempts < dry.maxSamples) return nullptr;
+
+            LayoutCandidate c;
+            c.layout = layout;
+            c.key = key;
+            c.attempts = est.attempts;
+            c.accepted = est.accepted;
+            double steps = 0.0;
+            for (const auto& [label, count] : est.labels) {
+                if (opt.targetBand.empty() || label == opt.targetBand) c.inBand += count;
+                const int from = bandIndex(label);
+                steps += count * (target < 0 || from < 0 ? 0 : std::abs(from - target));
+            }
+            c.bandDistance = c.accepted > 0 ? steps / c.accepted : 5.0;
+            c.msPerAttempt = est.msPerAttempt.estimate;
+            c.msPerTarget = c.inBand > 0 ? c.msPerAttempt * c.attempts / c.inBand : std::numeric_limits<double>::infinity();
+            c.meanMinMoves = est.meanMinMoves;
+            ++res.evaluated;
+            return &cache.emplace(key, std::move(c)).first->second;
+        };
+
+        const LayoutCandidate* first = evaluate(seed);
+        if (!first) {
+            res.cancelled = cancel && cancel->load();
+            res.elapsedMs = elapsedMs();
+            return res;
+        }
+        res.start = *first;
+        LayoutCandidate current = *first;
+        LayoutCandidate best = *first;
+        int idle = 0;
+        // Small layouts run out of unseen neighbours; cap proposals so the cache cannot spin forever.
+        const int maxProposals = 20 * std::max(1, opt.maxLayouts);
+        int proposals = 0;
+        while (!kinds.empty() && !stopped() && proposals < maxProposals) {
+            const LayoutCandidate* pick = nullptr;
+            for (int k = 0; k < std::max(1, opt.neighbours) && !stopped(); ++k, ++proposals) {
+                const LayoutCandidate* c = evaluate(propose(current.layout, 1));
+                if (c && c->key != current.key && (!pick || betterLayout(*c, *pick))) pick = c;
+            }
+            if (pick && betterLayout(*pick, current)) {
+                current = *pick;
+                idle = 0;
+                if (betterLayout(current, best)) {
+                    best = current;
+                    if (onImproved) onImproved(best, res.evaluated);
+                }
+                continue;
+            }
+            if (++idle < std::max(1, opt.patience)) continue;
+            // Stuck: jump a few edits away from the best layout and climb again from there.
+            idle = 0;
+            ++res.restarts;
+            ++proposals;
+            if (const LayoutCandidate* c = evaluate(propose(best.layout, 3))) current = *c;
+        }
+
+        res.best.reserve(cache.size());
+        for (auto& [key, c] : cache) res.best.push_back(std::move(c));
+        std::sort(res.best.begin(), res.best.end(), [](const LayoutCandidate& a, const LayoutCandidate& b) {
+            return betterLayout(a, b) || (!betterLayout(b, a) && a.key < b.key);
+        });
+        if ((int)res.best.size() > std::max(1, opt.keepBest)) res.best.resize((size_t)std::max(1, opt.keepBest));
+        res.elapsedMs = elapsedMs();
+        return res;
+    }
+
+} // namespace ws
@@ -0,0 +1,67 @@
+// ========================= src/core/TemplateOptimizer.hpp =========================
+#pragma once
+#include "YieldEstimator.hpp"
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ws {
+
+    struct LayoutSearchOptions {
+        std::string targetBand{ "Hard" };  // labelForScore band to pay for; empty accepts every map
+        int samplesPerLayout{ 32 };        // makeOne attempts per candidate layout
+        int neighbours{ 6 };               // mutations tried from the current layout per step
+        int patience{ 4 };                 // steps without improvement before a restart from the best
+        int maxLayouts{ 200 };             // distinct layouts evaluated, cache hits excluded
+        int timeBudgetMs{ 120000 };
+        double budgetScale{ 0.25 };        // solve/improve budgets per attempt, as in DryRunOptions
+        int workers{ 1 };
+        int keepBest{ 5 };
+        bool moveHeights{ true };          // move single cells between bottles; only with GenOptions::startMixed
+        bool moveGimmicks{ true };         // swap gimmicks between bottles, retarget Cloth
+        bool moveHidden{ false };          // move '?' flags between slots
+        uint64_t seed{ 0x1A70u };
+    };
+
+    struct LayoutCandidate {
+        State layout;                  // template: heights, gimmicks and '?' flags (colours are placeholders)
+        uint64_t key{ 0 };             // layoutKey(layout)
+        int attempts{ 0 };
+        int accepted{ 0 };
+        int inBand{ 0 };               // accepted maps labelled targetBand
+        double msPerAttempt{ 0.0 };    // timed-out attempts counted at the full solve budget, as in the dry run
+        double msPerTarget{ 0.0 };     // msPerAttempt / in-band rate; +infinity with no in-band map yet
+        double bandDistance{ 0.0 };    // mean band steps of accepted maps from targetBand (5 when none)
+        double meanMinMoves{ 0.0 };
+    };
+
+    struct LayoutSearchResult {
+        std::vector<LayoutCandidate> best;     // betterLayout order, distinct layouts
+        LayoutCandidate start;                 // the seed layout, for comparison
+        int evaluated{ 0 };                    // distinct layouts sampled
+        int cacheHits{ 0 };                    // proposals that were already sampled
+        int restarts{ 0 };
+        double elapsedMs{ 0.0 };
+        bool cancelled{ false };
+    };
+
+    // Identity of a layout for the cache: heights, gimmicks and '?' positions, not colours.
+    uint64_t layoutKey(const State& layout);
+
+    // Search order: any layout that produced a target-band map beats one that did not, and is then
+    // ranked by msPerTarget. Layouts without one are ranked by how near their maps land to the
+    // band, then by acceptance, so the climb still heads towards the band.
+    bool betterLayout(const LayoutCandidate& a, const LayoutCandidate& b);
+
+    // Local search over template layouts: from `seed`, sample `neighbours` single mutations per
+    // step with estimateTemplateYield and move to the best of them if it beats the current layout;
+    // after `patience` idle steps restart from a perturbed copy of the best. Every layout keeps
+    // the seed's height sum and gimmick counts, so each candidate is a valid template. All
+    // candidates sample with the same seed and streams, so they are compared on common random
+    // numbers. `onImproved` runs on the calling thread whenever a new best is found.
+    LayoutSearchResult optimizeTemplateLayout(const Params& p, const GenOptions& gen, const State& seed,
+        const LayoutSearchOptions& opt = {}, std::atomic<bool>* cancel = nullptr,
+        const std::function<void(const LayoutCandidate&, int evaluated)>& onImproved = {});
+
+} // namespace ws
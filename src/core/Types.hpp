@@ -57,10 +57,23 @@ namespace ws {
 
     struct Move { int from{ -1 }; int to{ -1 }; int amount{ 0 }; }; // amount = cells moved
 
+    // Gameplay rule variants shared with other titles; Rules.hpp holds what each one changes.
+    enum class RuleSetId : uint8_t { Classic = 0, SingleUnitPour = 1, BushOneNeighbour = 2 };
+    constexpr int kRuleSetCount = 3;
+
+    inline const char* ruleSetName(RuleSetId id) {
+        switch (id) {
+        case RuleSetId::SingleUnitPour: return "Single-unit pours";
+        case RuleSetId::BushOneNeighbour: return "Bush: one neighbour";
+        default: return "Classic";
+        }
+    }
+
     struct Params {
         int numColors{ 6 };     // 1..9 (UI clamp)
         int numBottles{ 8 };    // total stacks
         int capacity{ 4 };      // 3..50
+        RuleSetId ruleSet{ RuleSetId::Classic };
     };
 
     // Difficulty label bands
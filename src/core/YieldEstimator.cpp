@@ -0,0 +1,154 @@
+// ========================= src/core/YieldEstimator.cpp =========================
+#include "YieldEstimator.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace ws {
+
+    namespace {
+
+        constexpr double kZ = 1.96; // 95%
+
+        Interval wilson(int successes, int n) {
+            if (n <= 0) return Interval{ 0.0, 0.0, 1.0 };
+            const double ph = (double)successes / n;
+            const double z2 = kZ * kZ;
+            const double denom = 1.0 + z2 / n;
+            const double centre = (ph + z2 / (2.0 * n)) / denom;
+            const double half = kZ * std::sqrt(ph * (1.0 - ph) / n + z2 / (4.0 * n * n)) / denom;
+            return Interval{ ph, std::max(0.0, centre - half), std::min(1.0, centre + half) };
+        }
+
+        Interval meanInterval(double sum, double sumSq, int n) {
+            if (n <= 0) return Interval{};
+            const double mean = sum / n;
+            const double var = n > 1 ? std::max(0.0, (sumSq - sum * mean) / (n - 1)) : mean * mean;
+            const double half = kZ * std::sqrt(var / n);
+            return Interval{ mean, std::max(0.0, mean - half), mean + half };
+        }
+
+        // Time per accepted map = time per attempt / acceptance; the bounds pair pessimistic with pessimistic.
+        Interval perAccepted(const Interval& attempt, const Interval& acc) {
+            const double inf = std::numeric_limits<double>::infinity();
+            auto div = [&](double t, double p) { return p > 0.0 ? t / p : inf; };
+            return Interval{ div(attempt.estimate, acc.estimate), div(attempt.low, acc.high), div(attempt.high, acc.low) };
+        }
+
+    } // namespace
+
+    YieldEstimate estimateTemplateYield(const Params& p, const GenOptions& gen, const DryRunTemplate& tpl,
+        const DryRunOptions& opt, std::atomic<bool>* cancel) {
+        using clock = std::chrono::steady_clock;
+        const auto t0 = clock::now();
+        auto elapsedMs = [&] { return std::chrono::duration<double, std::milli>(clock::now() - t0).count(); };
+
+        GenOptions sampleOpt = gen;
+        sampleOpt.gimmickPlacementTries = 1;
+        sampleOpt.solveTimeMs = std::max(50, (int)std::lround(gen.solveTimeMs * opt.budgetScale));
+        sampleOpt.improveTimeMs = std::max(50, (int)std::lround(gen.improveTimeMs * opt.budgetScale));
+        const int workerCount = std::max(1, opt.workers);
+
+        std::mutex mu;
+        int attempts = 0;
+        int accepted = 0;
+        double timeSum = 0.0;
+        double timeSumSq = 0.0;
+        double movesSum = 0.0;
+        std::map<std::string, int> labels;
+        std::map<std::string, int> failures;
+        bool stop = false;
+        bool precise = false;
+
+        auto record = [&](double ms, const std::optional<Generated>& g, const std::string& reason) {
+            std::lock_guard<std::mutex> lock(mu);
+            if (stop) return;
+            // A solve that ran out of the reduced budget would have used the full one in the real run.
+            if (!g && ms >= sampleOpt.solveTimeMs) ms = ms * gen.solveTimeMs / sampleOpt.solveTimeMs;
+            ++attempts;
+            timeSum += ms;
+            timeSumSq += ms * ms;
+            if (g) {
+                ++accepted;
+                movesSum += g->minMoves;
+                ++labels[g->diffLabel];
+            }
+            else {
+                ++failures[reason.empty() ? std::string("Unknown failure") : reason];
+            }
+
+            if (attempts >= opt.maxSamples) { stop = true; return; }
+            if (attempts < opt.minSamples) return;
+            const auto acc = wilson(accepted, attempts);
+            const auto t = meanInterval(timeSum, timeSumSq, attempts);
+            const bool tightAcc = (acc.high - acc.low) * 0.5 <= opt.targetHalfWidth;
+            const bool tightTime = t.estimate <= 0.0 || (t.high - t.low) * 0.5 <= 0.25 * t.estimate;
+            if (tightAcc && tightTime) { stop = true; precise = true; }
+        };
+        auto stopped = [&] {
+            std::lock_guard<std::mutex> lock(mu);
+            if (!stop && (elapsedMs() >= opt.timeBudgetMs || (cancel && cancel->load()))) stop = true;
+            return stop;
+        };
+
+        auto work = [&](int workerIdx) {
+            GenOptions workerOpt = sampleOpt;
+            workerOpt.stream = static_cast<uint32_t>(workerIdx);
+            Generator g(p, workerOpt);
+            if (tpl.kind == DryRunTemplate::Kind::Fixed) g.setBase(tpl.fixed);
+            while (!stopped()) {
+                const auto a0 = clock::now();
+                std::string reason;
+                std::optional<Generated> made;
+                if (tpl.kind == DryRunTemplate::Kind::Auto) {
+                    auto built = g.buildRandomTemplate(tpl.cloth, tpl.vine, tpl.bush, tpl.questions, tpl.questionMaxPerBottle, &reason);
+                    if (!built) {
+                        if (reason.empty()) reason = "Failed to build template.";
+                    }
+                    else {
+                        g.setBase(*built);
+                        made = g.makeOne(nullptr, &reason);
+                    }
+                }
+                else {
+                    made = g.makeOne(nullptr, &reason);
+                }
+                record(std::chrono::duration<double, std::milli>(clock::now() - a0).count(), made, reason);
+            }
+        };
+
+        std::vector<std::thread> workers;
+        workers.reserve((size_t)workerCount - 1);
+        for (int w = 1; w < workerCount; ++w) workers.emplace_back(work, w);
+        work(0);
+        for (auto& w : workers) w.join();
+
+        YieldEstimate est;
+        est.attempts = attempts;
+        est.accepted = accepted;
+        est.acceptance = wilson(accepted, attempts);
+        est.msPerAttempt = meanInterval(timeSum, timeSumSq, attempts);
+        est.msPerAccepted = perAccepted(est.msPerAttempt, est.acceptance);
+        const double scale = (double)std::max(1, opt.batchCount) / workerCount;
+        est.batchMs = Interval{ est.msPerAccepted.estimate * scale, est.msPerAccepted.low * scale, est.msPerAccepted.high * scale };
+        est.meanMinMoves = accepted > 0 ? movesSum / accepted : 0.0;
+        est.labels.assign(labels.begin(), labels.end());
+        auto band = [](const std::string& l) {
+            static const char* order[] = { "Very Easy", "Easy", "Normal", "Hard", "Very Hard" };
+            for (int i = 0; i < 5; ++i) if (l == order[i]) return i;
+            return 5;
+        };
+        std::sort(est.labels.begin(), est.labels.end(), [&](const auto& a, const auto& b) { return band(a.first) < band(b.first); });
+        est.failures.assign(failures.begin(), failures.end());
+        std::stable_sort(est.failures.begin(), est.failures.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+        est.sampleSolveMs = sampleOpt.solveTimeMs;
+        est.elapsedMs = elapsedMs();
+        est.precise = precise;
+        return est;
+    }
+
+} // namespace ws
@@ -0,0 +1,62 @@
+// ========================= src/core/YieldEstimator.hpp =========================
+#pragma once
+#include "Generator.hpp"
+#include <atomic>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ws {
+
+    // Where each sampled attempt gets its template from, mirroring the two Generate buttons.
+    struct DryRunTemplate {
+        enum class Kind { None, Fixed, Auto };
+        Kind kind{ Kind::None };
+        State fixed;                  // Kind::Fixed: the template editor's state
+        int cloth{ 0 };               // Kind::Auto: buildRandomTemplate() arguments
+        int vine{ 0 };
+        int bush{ 0 };
+        int questions{ 0 };
+        int questionMaxPerBottle{ 0 };
+    };
+
+    struct DryRunOptions {
+        int minSamples{ 24 };
+        int maxSamples{ 400 };
+        int timeBudgetMs{ 15000 };
+        double targetHalfWidth{ 0.05 };  // stop once the acceptance CI is this tight (and time per attempt within 25%)
+        double budgetScale{ 0.25 };      // solve/improve budgets per attempt relative to the real run
+        int workers{ 1 };
+        int batchCount{ 10 };            // maps the real run would ask for
+    };
+
+    // 95% interval; high may be +infinity (e.g. time per accepted map with no acceptance yet).
+    struct Interval {
+        double estimate{ 0.0 };
+        double low{ 0.0 };
+        double high{ 0.0 };
+    };
+
+    struct YieldEstimate {
+        int attempts{ 0 };             // single generation tries (one scramble/deal + solve each)
+        int accepted{ 0 };
+        Interval acceptance;           // Wilson score interval at the sample budget
+        Interval msPerAttempt;         // timed-out attempts counted at the full solve budget
+        Interval msPerAccepted;
+        Interval batchMs;              // wall time for batchCount maps on `workers` threads
+        double meanMinMoves{ 0.0 };
+        std::vector<std::pair<std::string, int>> labels;   // difficulty band -> accepted maps, easiest first
+        std::vector<std::pair<std::string, int>> failures; // reason -> attempts, most frequent first
+        int sampleSolveMs{ 0 };
+        double elapsedMs{ 0.0 };
+        bool precise{ false };         // stopped because the intervals were tight, not on a cap
+    };
+
+    // Runs a bounded sample of generation attempts on `opt.workers` threads with scaled-down
+    // budgets and extrapolates the cost of a real batch. Each attempt is makeOne() with a single
+    // placement try, so failures are counted one by one with their reason. `cancel` may be set
+    // from another thread to stop early; the estimate then covers what was sampled.
+    YieldEstimate estimateTemplateYield(const Params& p, const GenOptions& gen, const DryRunTemplate& tpl,
+        const DryRunOptions& opt = {}, std::atomic<bool>* cancel = nullptr);
+
+} // namespace ws
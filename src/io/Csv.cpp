@@ -3,6 +3,7 @@
 #include <fstream>
 #include <sstream>
 #include <filesystem>
+#include <stdexcept>
 
 namespace ws {
 
@@ -71,17 +72,27 @@ namespace ws {
         row.MinMoves = minMoves;
         row.DifficultyScore = diffScore;
         row.DifficultyLabel = diffLabel;
+        row.RuleSet = (int)s.p.ruleSet;
         return row;
     }
 
+    // Same fields as repeated std::getline(sep): a trailing empty field is dropped.
     static std::vector<std::string> split(const std::string& s, char sep) {
-        std::vector<std::string> out; std::string cur; std::istringstream iss(s);
-        while (std::getline(iss, cur, sep)) out.push_back(cur);
+        std::vector<std::string> out;
+        size_t start = 0;
+        for (size_t i = 0; i <= s.size(); ++i) {
+            if (i == s.size() || s[i] == sep) {
+                out.emplace_back(s, start, i - start);
+                start = i + 1;
+            }
+        }
+        if (!out.empty() && out.back().empty()) out.pop_back();
         return out;
     }
 
     bool CsvIO::decode(const CsvRow& row, State& outState) {
         Params p; p.numColors = row.NumberOfItem; p.capacity = row.NumberOfSlot; p.numBottles = row.NumberOfStack;
+        p.ruleSet = (row.RuleSet >= 0 && row.RuleSet < kRuleSetCount) ? (RuleSetId)row.RuleSet : RuleSetId::Classic;
         State s; s.p = p; s.B.resize(p.numBottles); for (auto& b : s.B) b.capacity = p.capacity;
 
         // map
@@ -151,19 +162,69 @@ namespace ws {
         for (char c : s) { if (c == '"' || c == ',') { out.push_back('"'); out.push_back(c); out.push_back('"'); } else out.push_back(c); } return s;
     }
 
+    void CsvIO::writeHeader(std::ostream& f) {
+        f << "index,map,slot_gimmick,stack_gimmick,NumberOfItem,NumberOfSlot,NumberOfStack,MixCount,MinMoves,DifficultyScore,DifficultyLabel,RuleSet,MinMovesExact,MinMovesLowerBound\n";
+    }
+
+    void CsvIO::writeRow(std::ostream& f, const CsvRow& r) {
+        f << r.index << ',' << r.map << ',' << r.slot_gimmick << ',' << r.stack_gimmick << ','
+            << r.NumberOfItem << ',' << r.NumberOfSlot << ',' << r.NumberOfStack << ',' << r.MixCount << ','
+            << r.MinMoves << ',' << r.DifficultyScore << ',' << r.DifficultyLabel << ',' << r.RuleSet << ','
+            << (r.MinMovesExact ? 1 : 0) << ',' << r.MinMovesLowerBound << "\n";
+    }
+
+    bool CsvIO::parseLine(const std::string& line, CsvRow& out) {
+        auto cells = split(line, ',');
+        if (cells.size() < 11) return false;
+        try {
+            CsvRow r; int i = 0;
+            r.index = std::stoi(cells[i++]);
+            r.map = cells[i++];
+            r.slot_gimmick = cells[i++];
+            r.stack_gimmick = cells[i++];
+            r.NumberOfItem = std::stoi(cells[i++]);
+            r.NumberOfSlot = std::stoi(cells[i++]);
+            r.NumberOfStack = std::stoi(cells[i++]);
+            r.MixCount = std::stoi(cells[i++]);
+            r.MinMoves = std::stoi(cells[i++]);
+            r.DifficultyScore = std::stod(cells[i++]);
+            r.DifficultyLabel = cells[i++];
+            if (i < (int)cells.size() && !cells[i].empty()) r.RuleSet = std::stoi(cells[i++]);
+            if (i + 1 < (int)cells.size()) {
+                r.MinMovesExact = std::stoi(cells[i++]) != 0;
+                r.MinMovesLowerBound = std::stoi(cells[i++]);
+            }
+            out = std::move(r);
+            return true;
+        }
+        catch (const std::exception&) {
+            return false;
+        }
+    }
+
     bool CsvIO::save(const std::string& path, const std::vector<CsvRow>& rows, bool appendIfExists) {
         namespace fs = std::filesystem;
         bool exists = fs::exists(path);
+        if (exists && appendIfExists) {
+            // A file written with an older header gets rewritten in the current layout rather
+            // than collecting rows of a different width.
+            std::ifstream in(path);
+            std::string first;
+            std::getline(in, first);
+            if (!first.empty() && first.back() == '\r') first.pop_back();
+            std::ostringstream header;
+            writeHeader(header);
+            if (first + "\n" != header.str()) {
+                in.close();
+                auto all = load(path);
+                all.insert(all.end(), rows.begin(), rows.end());
+                return save(path, all, false);
+            }
+        }
         std::ofstream f(path, std::ios::out | (appendIfExists ? std::ios::app : std::ios::trunc));
         if (!f) return false;
-        if (!exists || !appendIfExists) {
-            f << "index,map,slot_gimmick,stack_gimmick,NumberOfItem,NumberOfSlot,NumberOfStack,MixCount,MinMoves,DifficultyScore,DifficultyLabel\n";
-        }
-        for (const auto& r : rows) {
-            f << r.index << ',' << r.map << ',' << r.slot_gimmick << ',' << r.stack_gimmick << ','
-                << r.NumberOfItem << ',' << r.NumberOfSlot << ',' << r.NumberOfStack << ',' << r.MixCount << ','
-                << r.MinMoves << ',' << r.DifficultyScore << ',' << r.DifficultyLabel << "\n";
-        }
+        if (!exists || !appendIfExists) writeHeader(f);
+        for (const auto& r : rows) writeRow(f, r);
         return true;
     }
 
@@ -174,21 +235,8 @@ namespace ws {
         while (std::getline(f, line)) {
             if (first) { first = false; continue; }
             if (line.empty()) continue;
-            auto cells = split(line, ',');
-            if (cells.size() < 11) continue;
-            CsvRow r; int i = 0;
-            r.index = std::stoi(cells[i++]);
-            r.map = cells[i++];
-            r.slot_gimmick = cells[i++];
-            r.stack_gimmick = cells[i++];
-            r.NumberOfItem = std::stoi(cells[i++]);
-            r.NumberOfSlot = std::stoi(cells[i++]);
-            r.NumberOfStack = std::stoi(cells[i++]);
-            r.MixCount = std::stoi(cells[i++]);
-            r.MinMoves = std::stoi(cells[i++]);
-            r.DifficultyScore = std::stod(cells[i++]);
-            r.DifficultyLabel = cells[i++];
-            out.push_back(std::move(r));
+            CsvRow r;
+            if (parseLine(line, r)) out.push_back(std::move(r));
         }
         return out;
     }
@@ -1,6 +1,7 @@
 // ========================= src/io/Csv.hpp =========================
 #pragma once
 #include "../core/State.hpp"
+#include <ostream>
 #include <string>
 #include <vector>
 
@@ -18,6 +19,9 @@ namespace ws {
         int MinMoves;
         double DifficultyScore;
         std::string DifficultyLabel;
+        int RuleSet{ 0 };       // RuleSetId; optional trailing column, 0 (Classic) when absent
+        bool MinMovesExact{ true };     // optional trailing columns too: Generated::minMovesExact
+        int MinMovesLowerBound{ -1 };   // and minMovesLowerBound, exact when absent
     };
 
     // Encode/Decode according to your exact spec
@@ -27,6 +31,11 @@ namespace ws {
 
         static bool save(const std::string& path, const std::vector<CsvRow>& rows, bool appendIfExists = true);
         static std::vector<CsvRow> load(const std::string& path);
+
+        // Row-at-a-time pieces of save/load, for tools that stream libraries too large to load.
+        static void writeHeader(std::ostream& out);
+        static void writeRow(std::ostream& out, const CsvRow& r);
+        static bool parseLine(const std::string& line, CsvRow& out); // false on short or malformed rows
     };
 
 } // namespace ws
\ No newline at end of file
@@ -0,0 +1,116 @@
+// ========================= src/io/ExternalSort.hpp =========================
+#pragma once
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <queue>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace ws {
+
+    // Sorts a stream of fixed-size records in bounded memory: records are buffered up to
+    // `runRecords`, each full buffer is sorted and spilled to a temp file, and next() does a
+    // k-way merge over the runs. A stream that fits in one run never touches the disk.
+    template <class T, class Less>
+    class ExternalSorter {
+        static_assert(std::is_trivially_copyable_v<T>, "records are spilled as raw bytes");
+
+    public:
+        ExternalSorter(std::string tempPrefix, size_t runRecords, Less less = Less{})
+            : prefix(std::move(tempPrefix)), runLimit(std::max<size_t>(runRecords, 1)), less(less) {
+            buffer.reserve(std::min<size_t>(runLimit, 1u << 16));
+        }
+        ~ExternalSorter() { removeRuns(); }
+        ExternalSorter(const ExternalSorter&) = delete;
+        ExternalSorter& operator=(const ExternalSorter&) = delete;
+
+        bool push(const T& r) {
+            buffer.push_back(r);
+            return buffer.size() < runLimit || spill();
+        }
+
+        // Ends input; false when a run could not be written.
+        bool finish() {
+            if (runs.empty()) {
+                std::stable_sort(buffer.begin(), buffer.end(), less);
+                inMemory = true;
+                return true;
+            }
+            if (!buffer.empty() && !spill()) return false;
+            buffer.clear();
+            buffer.shrink_to_fit();
+            for (size_t i = 0; i < runs.size(); ++i) {
+                readers.push_back(std::make_unique<std::ifstream>(runs[i], std::ios::binary));
+                if (!*readers.back()) return false;
+                T r;
+                if (readOne(i, r)) heap.push(Head{ r, i });
+            }
+            return true;
+        }
+
+        bool next(T& out) {
+            if (inMemory) {
+                if (cursor >= buffer.size()) return false;
+                out = buffer[cursor++];
+                return true;
+            }
+            if (heap.empty()) return false;
+            Head h = heap.top();
+            heap.pop();
+            out = h.record;
+            T r;
+            if (readOne(h.run, r)) heap.push(Head{ r, h.run });
+            return true;
+        }
+
+        size_t spilledRuns() const { return runs.size(); }
+
+    private:
+        struct Head { T record; size_t run; };
+        struct HeadGreater {
+            Less less;
+            // Ties go to the earlier run, which keeps the merge stable across runs.
+            bool operator()(const Head& a, const Head& b) const {
+                if (less(b.record, a.record)) return true;
+                if (less(a.record, b.record)) return false;
+                return a.run > b.run;
+            }
+        };
+
+        std::string prefix;
+        size_t runLimit;
+        Less less;
+        std::vector<T> buffer;
+        size_t cursor{ 0 };
+        bool inMemory{ false };
+        std::vector<std::string> runs;
+        std::vector<std::unique_ptr<std::ifstream>> readers;
+        std::priority_queue<Head, std::vector<Head>, HeadGreater> heap{ HeadGreater{ less } };
+
+        bool spill() {
+            std::stable_sort(buffer.begin(), buffer.end(), less);
+            const std::string path = prefix + ".run" + std::to_string(runs.size()) + ".tmp";
+            std::ofstream f(path, std::ios::binary | std::ios::trunc);
+            if (!f) return false;
+            runs.push_back(path);
+            f.write(reinterpret_cast<const char*>(buffer.data()), (std::streamsize)(buffer.size() * sizeof(T)));
+            buffer.clear();
+            return (bool)f;
+        }
+
+        bool readOne(size_t run, T& out) {
+            return (bool)readers[run]->read(reinterpret_cast<char*>(&out), sizeof(T));
+        }
+
+        void removeRuns() {
+            readers.clear();
+            std::error_code ec;
+            for (const auto& r : runs) std::filesystem::remove(r, ec);
+        }
+    };
+
+} // namespace ws
@@ -0,0 +1,109 @@
+// ========================= src/io/HintPack.cpp =========================
+#include "HintPack.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace ws {
+
+    static const char kHintMagic[8] = { 'W','S','H','I','N','T','0','1' };
+
+    static void putLE(std::vector<uint8_t>& out, uint64_t v, int bytes) {
+        for (int i = 0; i < bytes; ++i) out.push_back((uint8_t)(v >> (8 * i)));
+    }
+
+    static uint64_t getLE(const uint8_t* p, int bytes) {
+        uint64_t v = 0;
+        for (int i = 0; i < bytes; ++i) v |= uint64_t(p[i]) << (8 * i);
+        return v;
+    }
+
+    const HintEntry* HintPack::find(int mapIndex, uint64_t fingerprint) const {
+        auto it = std::lower_bound(maps.begin(), maps.end(), mapIndex,
+            [](const HintPackMap& m, int idx) { return m.index < idx; });
+        if (it == maps.end() || it->index != mapIndex) return nullptr;
+        return it->table.find(fingerprint);
+    }
+
+    bool HintPackIO::save(const std::string& path, const HintPack& pack, std::string* err) {
+        std::vector<const HintPackMap*> order;
+        for (const auto& m : pack.maps) order.push_back(&m);
+        std::sort(order.begin(), order.end(), [](const HintPackMap* a, const HintPackMap* b) { return a->index < b->index; });
+
+        std::vector<uint8_t> bytes(kHintMagic, kHintMagic + 8);
+        putLE(bytes, order.size(), 4);
+        uint64_t first = 0;
+        for (const auto* m : order) {
+            putLE(bytes, (uint32_t)m->index, 4);
+            putLE(bytes, first, 4);
+            putLE(bytes, m->table.entries.size(), 4);
+            putLE(bytes, (uint16_t)std::max(0, m->table.optimalMoves), 2);
+            putLE(bytes, m->table.complete ? 1 : 0, 1);
+            putLE(bytes, 0, 1);
+            first += m->table.entries.size();
+        }
+        if (first > 0xFFFFFFFFull) {
+            if (err) *err = "Too many hint entries for one pack.";
+            return false;
+        }
+        for (const auto* m : order) {
+            for (const auto& e : m->table.entries) {
+                putLE(bytes, e.fingerprint, 8);
+                bytes.push_back(e.from);
+                bytes.push_back(e.to);
+                bytes.push_back(e.amount);
+                bytes.push_back(e.distance);
+            }
+        }
+
+        std::ofstream f(path, std::ios::binary | std::ios::trunc);
+        if (!f) {
+            if (err) *err = "Could not open " + path + " for writing.";
+            return false;
+        }
+        f.write(reinterpret_cast<const char*>(bytes.data()), (std::streamsize)bytes.size());
+        return (bool)f;
+    }
+
+    std::optional<HintPack> HintPackIO::load(const std::string& path, std::string* err) {
+        auto fail = [&](const std::string& why) -> std::optional<HintPack> {
+            if (err) *err = why;
+            return std::nullopt;
+        };
+        std::ifstream f(path, std::ios::binary);
+        if (!f) return fail("Could not open " + path + ".");
+        std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+
+        if (bytes.size() < 12 || std::memcmp(bytes.data(), kHintMagic, 8) != 0) return fail("Not a hint pack.");
+        const size_t mapCount = (size_t)getLE(&bytes[8], 4);
+        const size_t dirEnd = 12 + mapCount * 16;
+        if (bytes.size() < dirEnd) return fail("Truncated hint pack directory.");
+        const size_t totalEntries = (bytes.size() - dirEnd) / 12;
+
+        HintPack pack;
+        pack.maps.resize(mapCount);
+        for (size_t i = 0; i < mapCount; ++i) {
+            const uint8_t* d = &bytes[12 + i * 16];
+            auto& m = pack.maps[i];
+            m.index = (int)(uint32_t)getLE(d, 4);
+            const size_t firstEntry = (size_t)getLE(d + 4, 4);
+            const size_t count = (size_t)getLE(d + 8, 4);
+            m.table.optimalMoves = (int)getLE(d + 12, 2);
+            m.table.complete = d[14] != 0;
+            if (firstEntry + count > totalEntries) return fail("Hint pack entry range out of bounds.");
+            m.table.entries.resize(count);
+            for (size_t k = 0; k < count; ++k) {
+                const uint8_t* e = &bytes[dirEnd + (firstEntry + k) * 12];
+                auto& out = m.table.entries[k];
+                out.fingerprint = getLE(e, 8);
+                out.from = e[8];
+                out.to = e[9];
+                out.amount = e[10];
+                out.distance = e[11];
+            }
+        }
+        return pack;
+    }
+
+} // namespace ws
@@ -0,0 +1,32 @@
+// ========================= src/io/HintPack.hpp =========================
+#pragma once
+#include "../core/HintTable.hpp"
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace ws {
+
+    struct HintPackMap {
+        int index{ 0 };         // map number, as in the CSV
+        HintTable table;
+    };
+
+    // Hint tables for a whole library. On disk (little-endian):
+    //   "WSHINT01", u32 mapCount,
+    //   mapCount x { u32 index, u32 firstEntry, u32 entryCount, u16 optimalMoves, u8 complete, u8 0 },
+    //   all entries x { u64 fingerprint, u8 from, u8 to, u8 amount, u8 distance }
+    // Maps are stored by ascending index and each map's entries by ascending fingerprint, so a
+    // client finds a hint with two binary searches straight over the mapped file.
+    struct HintPack {
+        std::vector<HintPackMap> maps;
+
+        const HintEntry* find(int mapIndex, uint64_t fingerprint) const;
+    };
+
+    struct HintPackIO {
+        static bool save(const std::string& path, const HintPack& pack, std::string* err = nullptr);
+        static std::optional<HintPack> load(const std::string& path, std::string* err = nullptr);
+    };
+
+} // namespace ws
@@ -0,0 +1,265 @@
+// ========================= src/io/LibraryDiff.cpp =========================
+#include "LibraryDiff.hpp"
+#include "Csv.hpp"
+#include "../core/Generator.hpp"
+#include "ExternalSort.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace ws {
+
+    namespace {
+
+        struct KeyRecord {
+            uint64_t key;
+            uint64_t offset;    // byte offset of the row in its file
+            uint32_t ordinal;   // row number in its file, header excluded
+            int32_t index;
+            int32_t minMoves;
+            int32_t pad;
+            double score;
+        };
+        struct KeyLess {
+            bool operator()(const KeyRecord& a, const KeyRecord& b) const {
+                return a.key != b.key ? a.key < b.key : a.ordinal < b.ordinal;
+            }
+        };
+        using KeySorter = ExternalSorter<KeyRecord, KeyLess>;
+
+        // Where each merged row comes from; sorted back into output order after the join.
+        struct MergeRecord {
+            uint64_t offset;
+            uint32_t rank;      // 0 = position of an old row, 1 = added row
+            uint32_t ordinal;
+            uint32_t side;      // 0 = old file, 1 = new file
+            uint32_t pad;
+        };
+        struct MergeLess {
+            bool operator()(const MergeRecord& a, const MergeRecord& b) const {
+                return a.rank != b.rank ? a.rank < b.rank : a.ordinal < b.ordinal;
+            }
+        };
+
+        bool fingerprintRow(const std::string& line, KeyRecord& out) {
+            CsvRow row;
+            if (!CsvIO::parseLine(line, row)) return false;
+            State s;
+            try {
+                if (!CsvIO::decode(row, s)) return false;
+            }
+            catch (const std::exception&) {
+                return false;
+            }
+            out.key = dedupFingerprint(s);
+            out.index = row.index;
+            out.minMoves = row.MinMoves;
+            out.score = row.DifficultyScore;
+            return true;
+        }
+
+        struct SideResult {
+            size_t rows{ 0 };
+            size_t unreadable{ 0 };
+            bool ok{ false };
+            std::string err;
+        };
+
+        // Streams one library through batches of parallel fingerprinting into `sorter`.
+        void fingerprintSide(const std::string& path, KeySorter& sorter, int workers, size_t batchRows, SideResult& res) {
+            std::ifstream f(path, std::ios::binary);
+            if (!f) { res.err = "Could not open " + path + "."; return; }
+            std::string line;
+            uint64_t offset = 0;
+            if (std::getline(f, line)) offset += line.size() + 1; // header
+
+            std::vector<std::string> lines;
+            std::vector<uint64_t> offsets;
+            std::vector<KeyRecord> recs;
+            std::vector<uint8_t> valid;
+            uint32_t ordinal = 0;
+            bool more = true;
+            while (more) {
+                lines.clear();
+                offsets.clear();
+                while (lines.size() < batchRows && (more = (bool)std::getline(f, line))) {
+                    const uint64_t at = offset;
+                    offset += line.size() + 1;
+                    if (!line.empty() && line.back() == '\r') line.pop_back();
+                    if (line.empty()) continue;
+                    lines.push_back(std::move(line));
+                    offsets.push_back(at);
+                }
+                const size_t n = lines.size();
+                if (n == 0) break;
+                recs.assign(n, KeyRecord{});
+                valid.assign(n, 0);
+                std::atomic<size_t> nextChunk{ 0 };
+                const size_t chunk = 256;
+                auto work = [&]() {
+                    for (size_t start; (start = nextChunk.fetch_add(chunk)) < n;) {
+                        for (size_t i = start; i < std::min(n, start + chunk); ++i) valid[i] = fingerprintRow(lines[i], recs[i]) ? 1 : 0;
+                    }
+                };
+                const int threads = std::max(1, std::min(workers, (int)((n + chunk - 1) / chunk)));
+                std::vector<std::thread> pool;
+                for (int t = 1; t < threads; ++t) pool.emplace_back(work);
+                work();
+                for (auto& t : pool) t.join();
+
+                for (size_t i = 0; i < n; ++i) {
+                    const uint32_t row = ordinal++;
+                    if (!valid[i]) { ++res.unreadable; continue; }
+                    recs[i].offset = offsets[i];
+                    recs[i].ordinal = row;
+                    if (!sorter.push(recs[i])) { res.err = "Could not spill a sorted run for " + path + "."; return; }
+                }
+                res.rows += n;
+            }
+            if (!sorter.finish()) { res.err = "Could not read back sorted runs for " + path + "."; return; }
+            res.ok = true;
+        }
+
+        // Next record whose key differs from `key`, counting the skipped repeats.
+        bool skipRepeats(KeySorter& sorter, uint64_t key, KeyRecord& cur, size_t& duplicates) {
+            while (sorter.next(cur)) {
+                if (cur.key != key) return true;
+                ++duplicates;
+            }
+            return false;
+        }
+
+        void reportRow(std::ofstream& out, const char* status, uint64_t key, const KeyRecord* a, const KeyRecord* b) {
+            char buf[32];
+            std::snprintf(buf, sizeof(buf), "%016" PRIx64, key);
+            out << status << ',' << buf;
+            auto cell = [&](const KeyRecord* r, auto field) {
+                out << ',';
+                if (r) out << r->*field;
+            };
+            cell(a, &KeyRecord::index); cell(b, &KeyRecord::index);
+            cell(a, &KeyRecord::minMoves); cell(b, &KeyRecord::minMoves);
+            cell(a, &KeyRecord::score); cell(b, &KeyRecord::score);
+            out << '\n';
+        }
+
+    } // namespace
+
+    bool diffLibraries(const std::string& oldPath, const std::string& newPath, const std::string& reportPath,
+        const std::string& mergedPath, const LibraryDiffOptions& opt, LibraryDiffSummary* summary, std::string* err) {
+        namespace fs = std::filesystem;
+        auto fail = [&](const std::string& why) {
+            if (err) *err = why;
+            return false;
+        };
+        const auto start = std::chrono::steady_clock::now();
+        LibraryDiffSummary sum;
+
+        fs::path tempDir = opt.tempDir.empty() ? fs::absolute(reportPath).parent_path() : fs::path(opt.tempDir);
+        const std::string tag = "wsdiff_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+        const std::string prefix = (tempDir / tag).string();
+
+        KeySorter oldKeys(prefix + "_old", opt.runRows);
+        KeySorter newKeys(prefix + "_new", opt.runRows);
+        SideResult oldRes, newRes;
+        {
+            const int perSide = std::max(1, opt.workers / 2);
+            const size_t batch = std::max<size_t>(opt.batchRows, 1);
+            std::thread other([&]() { fingerprintSide(newPath, newKeys, std::max(1, opt.workers - perSide), batch, newRes); });
+            fingerprintSide(oldPath, oldKeys, perSide, batch, oldRes);
+            other.join();
+        }
+        if (!oldRes.ok) return fail(oldRes.err);
+        if (!newRes.ok) return fail(newRes.err);
+        sum.oldRows = oldRes.rows;
+        sum.newRows = newRes.rows;
+        sum.unreadable = oldRes.unreadable + newRes.unreadable;
+        sum.spilledRuns = oldKeys.spilledRuns() + newKeys.spilledRuns();
+
+        std::ofstream report(reportPath, std::ios::trunc);
+        if (!report) return fail("Could not open " + reportPath + " for writing.");
+        report << "Status,Fingerprint,OldIndex,NewIndex,OldMinMoves,NewMinMoves,OldScore,NewScore\n";
+
+        ExternalSorter<MergeRecord, MergeLess> plan(prefix + "_merge", opt.runRows);
+        const bool merging = !mergedPath.empty();
+        bool planOk = true;
+        auto place = [&](uint32_t rank, uint32_t ordinal, uint32_t side, uint64_t offset) {
+            if (merging && !plan.push(MergeRecord{ offset, rank, ordinal, side, 0 })) planOk = false;
+        };
+
+        // Merge-join of the two key-sorted streams; within a side only the first row of a layout counts.
+        KeyRecord a{}, b{};
+        bool ha = oldKeys.next(a), hb = newKeys.next(b);
+        while (ha || hb) {
+            if (hb && (!ha || b.key < a.key)) {
+                ++sum.added;
+                reportRow(report, "added", b.key, nullptr, &b);
+                place(1, b.ordinal, 1, b.offset);
+                const KeyRecord cur = b;
+                hb = skipRepeats(newKeys, cur.key, b, sum.duplicatesNew);
+            }
+            else if (ha && (!hb || a.key < b.key)) {
+                ++sum.removed;
+                reportRow(report, "removed", a.key, &a, nullptr);
+                if (opt.keepRemoved) place(0, a.ordinal, 0, a.offset);
+                const KeyRecord cur = a;
+                ha = skipRepeats(oldKeys, cur.key, a, sum.duplicatesOld);
+            }
+            else {
+                const bool changed = a.minMoves != b.minMoves || std::fabs(a.score - b.score) > opt.scoreTolerance;
+                if (changed) {
+                    ++sum.changed;
+                    reportRow(report, "changed", a.key, &a, &b);
+                }
+                else {
+                    ++sum.unchanged;
+                }
+                if (changed && opt.preferNew) place(0, a.ordinal, 1, b.offset);
+                else place(0, a.ordinal, 0, a.offset);
+                const KeyRecord ca = a, cb = b;
+                ha = skipRepeats(oldKeys, ca.key, a, sum.duplicatesOld);
+                hb = skipRepeats(newKeys, cb.key, b, sum.duplicatesNew);
+            }
+        }
+        if (!report) return fail("Could not write " + reportPath + ".");
+        if (!planOk) return fail("Could not spill the merge plan.");
+
+        if (merging) {
+            if (!plan.finish()) return fail("Could not read back the merge plan.");
+            sum.spilledRuns += plan.spilledRuns();
+            std::ifstream sources[2] = { std::ifstream(oldPath, std::ios::binary), std::ifstream(newPath, std::ios::binary) };
+            std::ofstream merged(mergedPath, std::ios::trunc);
+            if (!merged) return fail("Could not open " + mergedPath + " for writing.");
+            CsvIO::writeHeader(merged);
+            MergeRecord m{};
+            std::string line;
+            int index = opt.firstIndex;
+            while (plan.next(m)) {
+                std::ifstream& src = sources[m.side];
+                src.clear();
+                src.seekg((std::streamoff)m.offset);
+                CsvRow row;
+                if (!std::getline(src, line)) return fail("Could not re-read a row of " + (m.side ? newPath : oldPath) + ".");
+                if (!line.empty() && line.back() == '\r') line.pop_back();
+                if (!CsvIO::parseLine(line, row)) return fail("A row changed while merging " + (m.side ? newPath : oldPath) + ".");
+                row.index = index++;
+                CsvIO::writeRow(merged, row);
+                ++sum.mergedRows;
+            }
+            if (!merged) return fail("Could not write " + mergedPath + ".");
+        }
+
+        sum.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (summary) *summary = sum;
+        return true;
+    }
+
+} // namespace ws
@@ -0,0 +1,46 @@
+// ========================= src/io/LibraryDiff.hpp =========================
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace ws {
+
+    struct LibraryDiffOptions {
+        int workers{ 2 };              // threads decoding and hashing rows, split between the two sides
+        size_t runRows{ 1u << 18 };    // rows per sorted run before spilling to disk (~40 bytes each)
+        size_t batchRows{ 1u << 14 };  // rows read and hashed per parallel batch
+        std::string tempDir;           // where runs are spilled; empty = next to the report
+        double scoreTolerance{ 1e-6 }; // DifficultyScore differences below this are not a change
+        bool preferNew{ true };        // changed maps take the new side's row in the merge
+        bool keepRemoved{ true };      // merge is a union; false drops maps missing from the new side
+        int firstIndex{ 0 };           // index of the first merged row
+    };
+
+    struct LibraryDiffSummary {
+        size_t oldRows{ 0 };
+        size_t newRows{ 0 };
+        size_t unreadable{ 0 };        // rows on either side that did not parse or decode
+        size_t duplicatesOld{ 0 };     // repeats of a layout within one side, dropped from the merge
+        size_t duplicatesNew{ 0 };
+        size_t unchanged{ 0 };
+        size_t changed{ 0 };           // same canonical layout, different MinMoves or score
+        size_t added{ 0 };
+        size_t removed{ 0 };
+        size_t mergedRows{ 0 };
+        size_t spilledRuns{ 0 };
+        double elapsedMs{ 0.0 };
+    };
+
+    // Compares two CSV libraries by canonical fingerprint (State::canonicalHash plus the rule
+    // set, so bottle order does not matter). Both sides are fingerprinted in parallel, sorted
+    // externally and merge-joined as streams, so memory stays bounded by the run and batch sizes.
+    //
+    // reportPath receives one CSV row per added, removed or changed map. When mergedPath is not
+    // empty it receives the deduplicated merge: old rows in their original order (changed ones
+    // replaced by the new row when preferNew), then added rows in new-file order, renumbered
+    // from firstIndex.
+    bool diffLibraries(const std::string& oldPath, const std::string& newPath, const std::string& reportPath,
+        const std::string& mergedPath, const LibraryDiffOptions& opt, LibraryDiffSummary* summary = nullptr,
+        std::string* err = nullptr);
+
+} // namespace ws
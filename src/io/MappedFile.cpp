@@ -0,0 +1,87 @@
+// ========================= src/io/MappedFile.cpp =========================
+#include "MappedFile.hpp"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ws {
+
+#ifdef _WIN32
+
+    bool MappedFile::open(const std::string& path, std::string* err) {
+        close();
+        auto fail = [&](const char* why) {
+            if (err) *err = std::string(why) + ": " + path;
+            close();
+            return false;
+        };
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return fail("Could not open");
+        fileHandle = file;
+        LARGE_INTEGER bytes{};
+        if (!GetFileSizeEx(file, &bytes)) return fail("Could not stat");
+        if (bytes.QuadPart == 0) return fail("Empty file");
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) return fail("Could not map");
+        mappingHandle = mapping;
+        void* p = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!p) return fail("Could not map");
+        view = static_cast<const uint8_t*>(p);
+        length = (size_t)bytes.QuadPart;
+        return true;
+    }
+
+    void MappedFile::close() {
+        if (view) UnmapViewOfFile(view);
+        if (mappingHandle) CloseHandle(static_cast<HANDLE>(mappingHandle));
+        if (fileHandle) CloseHandle(static_cast<HANDLE>(fileHandle));
+        view = nullptr;
+        length = 0;
+        mappingHandle = nullptr;
+        fileHandle = nullptr;
+    }
+
+#else
+
+    bool MappedFile::open(const std::string& path, std::string* err) {
+        close();
+        auto fail = [&](const char* why) {
+            if (err) *err = std::string(why) + ": " + path;
+            close();
+            return false;
+        };
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return fail("Could not open");
+        struct stat st {};
+        if (fstat(fd, &st) != 0) return fail("Could not stat");
+        if (st.st_size == 0) return fail("Empty file");
+        void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) return fail("Could not map");
+        view = static_cast<const uint8_t*>(p);
+        length = (size_t)st.st_size;
+        return true;
+    }
+
+    void MappedFile::close() {
+        if (view) munmap(const_cast<uint8_t*>(view), length);
+        if (fd >= 0) ::close(fd);
+        view = nullptr;
+        length = 0;
+        fd = -1;
+    }
+
+#endif
+
+} // namespace ws
@@ -0,0 +1,35 @@
+// ========================= src/io/MappedFile.hpp =========================
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ws {
+
+    // Read-only memory map of a whole file (CreateFileMapping on Windows, mmap elsewhere).
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile() { close(); }
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool open(const std::string& path, std::string* err = nullptr);
+        void close();
+
+        const uint8_t* data() const { return view; }
+        size_t size() const { return length; }
+        bool isOpen() const { return view != nullptr; }
+
+    private:
+        const uint8_t* view{ nullptr };
+        size_t length{ 0 };
+#ifdef _WIN32
+        void* fileHandle{ nullptr };
+        void* mappingHandle{ nullptr };
+#else
+        int fd{ -1 };
+#endif
+    };
+
+} // namespace ws
@@ -0,0 +1,67 @@
+// ========================= src/io/MoveOrderFile.cpp =========================
+#include "MoveOrderFile.hpp"
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+namespace ws {
+
+    static const char kMoveMagic[8] = { 'W','S','M','O','V','E','0','1' };
+
+    static void putLE(std::vector<uint8_t>& out, uint32_t v) {
+        for (int i = 0; i < 4; ++i) out.push_back((uint8_t)(v >> (8 * i)));
+    }
+
+    static uint32_t getLE(const uint8_t* p) {
+        uint32_t v = 0;
+        for (int i = 0; i < 4; ++i) v |= uint32_t(p[i]) << (8 * i);
+        return v;
+    }
+
+    bool MoveOrderIO::save(const std::string& path, const MoveOrderModel& model, std::string* err) {
+        std::vector<uint8_t> bytes(kMoveMagic, kMoveMagic + 8);
+        putLE(bytes, MoveOrderModel::kFeatureCount);
+        putLE(bytes, MoveOrderModel::kTableSize);
+        for (float w : model.weights) {
+            uint32_t bits = 0;
+            std::memcpy(&bits, &w, 4);
+            putLE(bytes, bits);
+        }
+
+        std::ofstream f(path, std::ios::binary | std::ios::trunc);
+        if (!f) {
+            if (err) *err = "Could not open " + path + " for writing.";
+            return false;
+        }
+        f.write(reinterpret_cast<const char*>(bytes.data()), (std::streamsize)bytes.size());
+        return (bool)f;
+    }
+
+    std::optional<MoveOrderModel> MoveOrderIO::load(const std::string& path, std::string* err) {
+        auto fail = [&](const std::string& why) -> std::optional<MoveOrderModel> {
+            if (err) *err = why;
+            return std::nullopt;
+        };
+        std::ifstream f(path, std::ios::binary);
+        if (!f) return fail("Could not open " + path + ".");
+        std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+
+        if (bytes.size() < 16 || std::memcmp(bytes.data(), kMoveMagic, 8) != 0) return fail("Not a move-order model.");
+        if (getLE(&bytes[8]) != (uint32_t)MoveOrderModel::kFeatureCount || getLE(&bytes[12]) != (uint32_t)MoveOrderModel::kTableSize)
+            return fail("Move-order model was trained with a different feature set.");
+        if (bytes.size() != 16 + 4 * (size_t)MoveOrderModel::kTableSize) return fail("Truncated move-order model.");
+
+        MoveOrderModel model;
+        for (int i = 0; i < MoveOrderModel::kTableSize; ++i) {
+            const uint32_t bits = getLE(&bytes[16 + 4 * (size_t)i]);
+            float w = 0.0f;
+            std::memcpy(&w, &bits, 4);
+            if (!std::isfinite(w)) return fail("Move-order model has a non-finite weight.");
+            model.weights[(size_t)i] = w;
+        }
+        return model;
+    }
+
+} // namespace ws
@@ -0,0 +1,17 @@
+// ========================= src/io/MoveOrderFile.hpp =========================
+#pragma once
+#include "../core/MoveOrder.hpp"
+#include <optional>
+#include <string>
+
+namespace ws {
+
+    // Trained move-order weights. On disk (little-endian):
+    //   "WSMOVE01", u32 featureCount, u32 tableSize, tableSize x f32 weight
+    // A file whose shape differs from this build's MoveOrderModel is rejected, not adapted.
+    struct MoveOrderIO {
+        static bool save(const std::string& path, const MoveOrderModel& model, std::string* err = nullptr);
+        static std::optional<MoveOrderModel> load(const std::string& path, std::string* err = nullptr);
+    };
+
+} // namespace ws
@@ -0,0 +1,289 @@
+// ========================= src/io/Session.cpp =========================
+#include "Session.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace ws {
+
+    static const char kSessionMagic[8] = { 'W','S','S','E','S','S','0','1' };
+
+    namespace {
+
+        void putLE(std::vector<uint8_t>& out, uint64_t v, int bytes) {
+            for (int i = 0; i < bytes; ++i) out.push_back((uint8_t)(v >> (8 * i)));
+        }
+
+        void putF64(std::vector<uint8_t>& out, double v) {
+            uint64_t b; std::memcpy(&b, &v, 8); putLE(out, b, 8);
+        }
+
+        // Bounds-checked cursor over a slice of the mapped file.
+        struct Cursor {
+            const uint8_t* p;
+            const uint8_t* end;
+            bool ok{ true };
+            bool has(size_t n) const { return ok && (size_t)(end - p) >= n; }
+            uint64_t u(int n) {
+                if (!has((size_t)n)) { ok = false; return 0; }
+                uint64_t v = 0;
+                for (int i = 0; i < n; ++i) v |= uint64_t(p[i]) << (8 * i);
+                p += n;
+                return v;
+            }
+            double f64() { uint64_t b = u(8); double v; std::memcpy(&v, &b, 8); return v; }
+        };
+
+        bool fitsByte(int v) { return v >= 0 && v <= 255; }
+
+        bool encodeState(std::vector<uint8_t>& out, const State& s) {
+            if (!fitsByte(s.p.numColors) || !fitsByte(s.p.numBottles) || !fitsByte(s.p.capacity) || s.B.size() > 255) return false;
+            out.push_back((uint8_t)s.p.numColors);
+            out.push_back((uint8_t)s.p.numBottles);
+            out.push_back((uint8_t)s.p.capacity);
+            out.push_back((uint8_t)s.p.ruleSet);
+            out.push_back((uint8_t)s.B.size());
+            for (const auto& b : s.B) {
+                if (!fitsByte(b.capacity) || b.slots.size() > 255) return false;
+                out.push_back((uint8_t)b.capacity);
+                out.push_back((uint8_t)b.gimmick.kind);
+                out.push_back(b.gimmick.clothTarget);
+                out.push_back((uint8_t)b.slots.size());
+                for (const auto& s : b.slots) out.push_back((uint8_t)((s.c & 0x7F) | (s.hidden ? 0x80 : 0)));
+            }
+            return true;
+        }
+
+        bool decodeState(Cursor& c, State& s) {
+            s = State{};
+            s.p.numColors = (int)c.u(1);
+            s.p.numBottles = (int)c.u(1);
+            s.p.capacity = (int)c.u(1);
+            const int rules = (int)c.u(1);
+            s.p.ruleSet = (RuleSetId)(rules < kRuleSetCount ? rules : 0);
+            const int bottles = (int)c.u(1);
+            if (!c.ok) return false;
+            s.B.resize((size_t)bottles);
+            for (auto& b : s.B) {
+                b.capacity = (int)c.u(1);
+                const int kind = (int)c.u(1);
+                b.gimmick.kind = (StackGimmickKind)(kind <= (int)StackGimmickKind::Bush ? kind : 0);
+                b.gimmick.clothTarget = (Color)c.u(1);
+                const size_t cells = (size_t)c.u(1);
+                if (!c.has(cells)) return false;
+                b.slots.resize(cells);
+                for (auto& slot : b.slots) {
+                    const uint8_t v = *c.p++;
+                    slot.c = (Color)(v & 0x7F);
+                    slot.hidden = (v & 0x80) != 0;
+                }
+            }
+            if (bottles > 0) s.refreshLocks();
+            return c.ok;
+        }
+
+        bool encodeMoves(std::vector<uint8_t>& out, const std::vector<Move>& moves) {
+            putLE(out, moves.size(), 4);
+            for (const auto& m : moves) {
+                if (!fitsByte(m.from) || !fitsByte(m.to) || !fitsByte(m.amount)) return false;
+                out.push_back((uint8_t)m.from);
+                out.push_back((uint8_t)m.to);
+                out.push_back((uint8_t)m.amount);
+            }
+            return true;
+        }
+
+        bool decodeMoves(Cursor& c, std::vector<Move>& moves) {
+            const size_t n = (size_t)c.u(4);
+            if (!c.has(n * 3)) return false;
+            moves.resize(n);
+            for (auto& m : moves) {
+                m.from = c.p[0];
+                m.to = c.p[1];
+                m.amount = c.p[2];
+                c.p += 3;
+            }
+            return true;
+        }
+
+        using Breakdown = SolveResult::DifficultyBreakdown;
+        constexpr double Breakdown::* kDifficultyFields[] = {
+            &Breakdown::moveComponent, &Breakdown::heuristicComponent, &Breakdown::fragmentationComponent,
+            &Breakdown::hiddenComponent, &Breakdown::emptyBottleComponent, &Breakdown::solvedBottleComponent,
+            &Breakdown::gimmickComponent, &Breakdown::hiddenGimmickInteractionComponent, &Breakdown::colorComponent,
+            &Breakdown::solutionComponent, &Breakdown::totalScore,
+        };
+        static_assert(sizeof(Breakdown) == sizeof(kDifficultyFields) / sizeof(kDifficultyFields[0]) * sizeof(double),
+            "DifficultyBreakdown changed; update the session record");
+
+        void encodeSettings(std::vector<uint8_t>& out, const SessionSettings& s) {
+            std::vector<uint8_t> b;
+            auto i32 = [&](int v) { putLE(b, (uint32_t)v, 4); };
+            i32(s.params.numColors); i32(s.params.numBottles); i32(s.params.capacity); i32((int)s.params.ruleSet);
+            i32(s.gen.mixMin); i32(s.gen.mixMax); putLE(b, s.gen.seed, 8);
+            i32(s.gen.gimmickPlacementTries); i32(s.gen.solveTimeMs);
+            i32(s.gen.startMixed); i32(s.gen.reservedEmpty); i32(s.gen.maxRunPerBottle); i32(s.gen.randomizeHeights);
+            i32(s.gen.improveOnTimeout); i32(s.gen.improveTimeMs);
+            i32(s.toGenerate); i32(s.autoCount);
+            i32(s.clothCount); i32(s.vineCount); i32(s.bushCount); i32(s.questionCount); i32(s.questionMaxPerBottle);
+            i32(s.workerThreads); i32(s.useTemplate);
+            i32(s.currentIndex); i32(s.playbackStep); i32(s.playbackScramble);
+            putF64(b, s.gen.solveWeight);
+            i32(s.gen.adaptiveScramble); putF64(b, s.gen.mixTarget); putF64(b, s.gen.mixEntropyTarget); i32(s.gen.mixHeuristicTarget);
+            i32((int)s.cpu.mode); putF64(b, s.cpu.share); i32(s.cpu.cores); putF64(b, s.cpu.headroom); i32(s.cpu.lowPriority);
+            putLE(out, b.size(), 4);
+            out.insert(out.end(), b.begin(), b.end());
+        }
+
+        // Fields missing from a shorter (older) block keep their defaults.
+        void decodeSettings(Cursor c, SessionSettings& s) {
+            auto i32 = [&](int& v) { if (c.has(4)) v = (int)(int32_t)c.u(4); };
+            auto flag = [&](bool& v) { if (c.has(4)) v = c.u(4) != 0; };
+            int rules = 0;
+            i32(s.params.numColors); i32(s.params.numBottles); i32(s.params.capacity); i32(rules);
+            s.params.ruleSet = (RuleSetId)(rules >= 0 && rules < kRuleSetCount ? rules : 0);
+            i32(s.gen.mixMin); i32(s.gen.mixMax); if (c.has(8)) s.gen.seed = c.u(8);
+            i32(s.gen.gimmickPlacementTries); i32(s.gen.solveTimeMs);
+            flag(s.gen.startMixed); i32(s.gen.reservedEmpty); i32(s.gen.maxRunPerBottle); flag(s.gen.randomizeHeights);
+            flag(s.gen.improveOnTimeout); i32(s.gen.improveTimeMs);
+            i32(s.toGenerate); i32(s.autoCount);
+            i32(s.clothCount); i32(s.vineCount); i32(s.bushCount); i32(s.questionCount); i32(s.questionMaxPerBottle);
+            i32(s.workerThreads); flag(s.useTemplate);
+            i32(s.currentIndex); i32(s.playbackStep); flag(s.playbackScramble);
+            if (c.has(8)) s.gen.solveWeight = std::max(1.0, c.f64());
+            flag(s.gen.adaptiveScramble);
+            if (c.has(8)) s.gen.mixTarget = c.f64();
+            if (c.has(8)) s.gen.mixEntropyTarget = c.f64();
+            i32(s.gen.mixHeuristicTarget);
+            int cpuMode = 0;
+            i32(cpuMode);
+            s.cpu.mode = (CpuCapMode)(cpuMode >= 0 && cpuMode < kCpuCapModeCount ? cpuMode : 0);
+            if (c.has(8)) s.cpu.share = std::clamp(c.f64(), 0.05, 1.0);
+            i32(s.cpu.cores);
+            if (c.has(8)) s.cpu.headroom = std::max(0.0, c.f64());
+            flag(s.cpu.lowPriority);
+        }
+
+    } // namespace
+
+    bool SessionWriter::addMap(const Generated& g) {
+        const size_t start = records.size();
+        auto rollback = [&]() { records.resize(start); return false; };
+        if (!encodeState(records, g.state) || !encodeState(records, g.scrambleStart)) return rollback();
+        putLE(records, (uint32_t)g.mixCount, 4);
+        putLE(records, (uint32_t)g.minMoves, 4);
+        records.push_back(g.minMovesExact ? 1 : 0);
+        putLE(records, (uint32_t)g.minMovesLowerBound, 4);
+        putF64(records, g.diffScore);
+        const size_t labelLen = g.diffLabel.size() < 255 ? g.diffLabel.size() : 255;
+        records.push_back((uint8_t)labelLen);
+        records.insert(records.end(), g.diffLabel.begin(), g.diffLabel.begin() + (long)labelLen);
+        if (!encodeMoves(records, g.scrambleMoves) || !encodeMoves(records, g.solutionMoves)) return rollback();
+        for (auto field : kDifficultyFields) putF64(records, g.difficulty.*field);
+        offsets.push_back(start);
+        return true;
+    }
+
+    void SessionWriter::addEncodedMap(const uint8_t* data, size_t size) {
+        offsets.push_back(records.size());
+        records.insert(records.end(), data, data + size);
+    }
+
+    bool SessionWriter::writeTo(const std::string& path, std::string* err) const {
+        auto fail = [&](const std::string& why) {
+            if (err) *err = why;
+            return false;
+        };
+        std::vector<uint8_t> head(kSessionMagic, kSessionMagic + 8);
+        putLE(head, offsets.size(), 4);
+        encodeSettings(head, settings);
+        if (!encodeState(head, tpl)) return fail("Template does not fit the session format.");
+        const uint64_t dataAt = head.size() + (offsets.size() + 1) * 8;
+        for (uint64_t o : offsets) putLE(head, dataAt + o, 8);
+        putLE(head, dataAt + records.size(), 8);
+
+        const std::string tmp = path + ".tmp";
+        {
+            std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+            if (!f) return fail("Could not open " + tmp + " for writing.");
+            f.write(reinterpret_cast<const char*>(head.data()), (std::streamsize)head.size());
+            f.write(reinterpret_cast<const char*>(records.data()), (std::streamsize)records.size());
+            if (!f) return fail("Could not write " + tmp + ".");
+        }
+        std::error_code ec;
+        std::filesystem::rename(tmp, path, ec);
+        if (ec) return fail("Could not replace " + path + ": " + ec.message());
+        return true;
+    }
+
+    bool SessionReader::open(const std::string& path, std::string* err) {
+        close();
+        auto fail = [&](const std::string& why) {
+            if (err) *err = why;
+            close();
+            return false;
+        };
+        if (!file.open(path, err)) return false;
+        const uint8_t* base = file.data();
+        Cursor c{ base, base + file.size() };
+        if (!c.has(8) || std::memcmp(base, kSessionMagic, 8) != 0) return fail("Not a session snapshot: " + path);
+        c.p += 8;
+        count = (size_t)c.u(4);
+        const size_t settingsBytes = (size_t)c.u(4);
+        if (!c.has(settingsBytes)) return fail("Session snapshot is truncated.");
+        decodeSettings(Cursor{ c.p, c.p + settingsBytes }, sessionSettings);
+        c.p += settingsBytes;
+        if (!decodeState(c, tpl)) return fail("Session template is corrupt.");
+        indexAt = (size_t)(c.p - base);
+        if (!c.has((count + 1) * 8)) return fail("Session index is truncated.");
+        dataAt = indexAt + (count + 1) * 8;
+        if (recordOffset(0) != dataAt || recordOffset(count) != file.size()) return fail("Session index is corrupt.");
+        filePath = path;
+        return true;
+    }
+
+    void SessionReader::close() {
+        file.close();
+        filePath.clear();
+        sessionSettings = SessionSettings{};
+        tpl = State{};
+        count = 0;
+        indexAt = dataAt = 0;
+    }
+
+    uint64_t SessionReader::recordOffset(size_t i) const {
+        Cursor c{ file.data() + indexAt + i * 8, file.data() + file.size() };
+        return c.u(8);
+    }
+
+    std::pair<const uint8_t*, size_t> SessionReader::encodedMap(size_t i) const {
+        if (i >= count) return { nullptr, 0 };
+        const uint64_t from = recordOffset(i), to = recordOffset(i + 1);
+        if (from < dataAt || to < from || to > file.size()) return { nullptr, 0 };
+        return { file.data() + from, (size_t)(to - from) };
+    }
+
+    bool SessionReader::decodeMap(size_t i, Generated& out) const {
+        const auto rec = encodedMap(i);
+        if (!rec.first) return false;
+        Cursor c{ rec.first, rec.first + rec.second };
+        Generated g;
+        if (!decodeState(c, g.state) || !decodeState(c, g.scrambleStart)) return false;
+        g.mixCount = (int)(int32_t)c.u(4);
+        g.minMoves = (int)(int32_t)c.u(4);
+        g.minMovesExact = c.u(1) != 0;
+        g.minMovesLowerBound = (int)(int32_t)c.u(4);
+        g.diffScore = c.f64();
+        const size_t labelLen = (size_t)c.u(1);
+        if (!c.has(labelLen)) return false;
+        g.diffLabel.assign(reinterpret_cast<const char*>(c.p), labelLen);
+        c.p += labelLen;
+        if (!decodeMoves(c, g.scrambleMoves) || !decodeMoves(c, g.solutionMoves)) return false;
+        for (auto field : kDifficultyFields) g.difficulty.*field = c.f64();
+        if (!c.ok) return false;
+        out = std::move(g);
+        return true;
+    }
+
+} // namespace ws
@@ -0,0 +1,86 @@
+// ========================= src/io/Session.hpp =========================
+#pragma once
+#include "../core/Generator.hpp"
+#include "../core/CpuGovernor.hpp"
+#include "MappedFile.hpp"
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ws {
+
+    // Everything besides the pool and the template that a restart should bring back.
+    struct SessionSettings {
+        Params params;
+        GenOptions gen;
+        int toGenerate{ 5 };
+        int autoCount{ 5 };
+        int clothCount{ 0 };
+        int vineCount{ 0 };
+        int bushCount{ 0 };
+        int questionCount{ 0 };
+        int questionMaxPerBottle{ 0 };
+        int workerThreads{ 1 };
+        CpuGovernorOptions cpu;
+        bool useTemplate{ true };
+        int currentIndex{ -1 };
+        int playbackStep{ 0 };
+        bool playbackScramble{ false };
+    };
+
+    // Session snapshot on disk (little-endian):
+    //   "WSSESS01", u32 mapCount, u32 settingsBytes, settings fields, template state,
+    //   (mapCount + 1) x u64 record offsets, map records.
+    // The settings block is length-prefixed so older snapshots load with defaults for fields
+    // added later. A map record packs each cell into one byte (colour | hidden << 7) and each
+    // move into three, so a record is usually a couple of hundred bytes.
+    class SessionWriter {
+    public:
+        void setSettings(const SessionSettings& s) { settings = s; }
+        void setTemplate(const State& t) { tpl = t; }
+        // False when the map does not fit the record format (more than 255 bottles or cells).
+        bool addMap(const Generated& g);
+        // A record copied verbatim from SessionReader::encodedMap().
+        void addEncodedMap(const uint8_t* data, size_t size);
+        size_t mapCount() const { return offsets.size(); }
+
+        // Writes to a temp file next to `path` and renames it over the target.
+        bool writeTo(const std::string& path, std::string* err = nullptr) const;
+
+    private:
+        SessionSettings settings;
+        State tpl;
+        std::vector<uint8_t> records;
+        std::vector<uint64_t> offsets; // start of each record in `records`
+    };
+
+    // Maps a snapshot and decodes only the header, settings and template up front; map records
+    // are decoded one at a time on request, so opening is independent of the pool size.
+    class SessionReader {
+    public:
+        bool open(const std::string& path, std::string* err = nullptr);
+        void close();
+        bool isOpen() const { return file.isOpen(); }
+        const std::string& path() const { return filePath; }
+
+        const SessionSettings& settings() const { return sessionSettings; }
+        const State& templateState() const { return tpl; }
+        size_t mapCount() const { return count; }
+
+        bool decodeMap(size_t i, Generated& out) const;
+        std::pair<const uint8_t*, size_t> encodedMap(size_t i) const;
+
+    private:
+        MappedFile file;
+        std::string filePath;
+        SessionSettings sessionSettings;
+        State tpl;
+        size_t count{ 0 };
+        size_t indexAt{ 0 };  // byte offset of the record offset table
+        size_t dataAt{ 0 };   // byte offset of the first record
+
+        uint64_t recordOffset(size_t i) const;
+    };
+
+} // namespace ws
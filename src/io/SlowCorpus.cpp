@@ -0,0 +1,158 @@
+// ========================= src/io/SlowCorpus.cpp =========================
+#include "SlowCorpus.hpp"
+#include "Csv.hpp"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace ws {
+
+    namespace {
+
+        const char* kExtraHeader = ",Seed,Stream,Attempt,SolveTimeMs,SolveWeight,ElapsedMs,LowerBound,CountWorkers,MoveOrder";
+        constexpr size_t kBaseColumns = 14;   // CsvIO columns up to and including MinMovesLowerBound
+
+        const char* outcomeName(const SlowAttempt& a) {
+            if (a.timedOut) return "timeout";
+            return a.solved ? "slow" : "unsolved";
+        }
+
+        std::vector<std::string> splitCells(const std::string& line) {
+            std::vector<std::string> out;
+            std::stringstream ss(line);
+            std::string cell;
+            while (std::getline(ss, cell, ',')) out.push_back(cell);
+            return out;
+        }
+
+        void loadFile(const std::string& path, std::vector<SlowAttempt>& out) {
+            std::ifstream f(path);
+            std::string line;
+            if (!std::getline(f, line)) return; // header
+            while (std::getline(f, line)) {
+                if (!line.empty() && line.back() == '\r') line.pop_back();
+                CsvRow row;
+                if (line.empty() || !CsvIO::parseLine(line, row)) continue;
+                const auto cells = splitCells(line);
+                if (cells.size() < kBaseColumns + 9) continue;
+                SlowAttempt a;
+                try {
+                    if (!CsvIO::decode(row, a.state)) continue;
+                    size_t i = kBaseColumns;
+                    a.seed = std::stoull(cells[i++]);
+                    a.stream = (uint32_t)std::stoul(cells[i++]);
+                    a.attempt = std::stoull(cells[i++]);
+                    a.solveTimeMs = std::stoi(cells[i++]);
+                    a.solveWeight = std::stod(cells[i++]);
+                    a.elapsedMs = std::stod(cells[i++]);
+                    a.lowerBound = std::stoi(cells[i++]);
+                    a.countWorkers = std::stoi(cells[i++]);
+                    a.moveOrder = std::stoi(cells[i++]) != 0;
+                }
+                catch (const std::exception&) {
+                    continue;
+                }
+                a.minMoves = row.MinMoves;
+                a.timedOut = row.DifficultyLabel == "timeout";
+                a.solved = row.DifficultyLabel == "slow";
+                out.push_back(std::move(a));
+            }
+        }
+
+        // Index of the last readable row of `path`, or 0 when it has none.
+        int lastIndex(const std::string& path) {
+            std::ifstream f(path);
+            std::string line;
+            int last = 0;
+            if (!std::getline(f, line)) return 0; // header
+            while (std::getline(f, line)) {
+                if (!line.empty() && line.back() == '\r') line.pop_back();
+                CsvRow row;
+                if (!line.empty() && CsvIO::parseLine(line, row)) last = row.index;
+            }
+            return last;
+        }
+
+    } // namespace
+
+    SlowAttemptCorpus::SlowAttemptCorpus(std::string path, SlowCorpusOptions o)
+        :filePath(std::move(path)), opt(o), rng(0x510C0DE5ULL) {
+        std::error_code ec;
+        const auto size = std::filesystem::file_size(filePath, ec);
+        bytes = ec ? 0 : (uint64_t)size;
+        int last = bytes > 0 ? lastIndex(filePath) : 0;
+        if (last == 0) last = lastIndex(filePath + ".1");
+        nextIndex = last + 1;
+    }
+
+    bool SlowAttemptCorpus::record(const SlowAttempt& a) {
+        namespace fs = std::filesystem;
+        std::lock_guard<std::mutex> lock(m);
+        if (opt.sampleRate < 1.0 && (double)(rng.next() >> 11) * 0x1.0p-53 >= opt.sampleRate) {
+            ++skipped;
+            return false;
+        }
+
+        std::ostringstream row;
+        CsvRow base = CsvIO::encode(nextIndex, a.state, 0, a.minMoves, 0.0, outcomeName(a));
+        base.MinMovesExact = a.solved && a.lowerBound >= a.minMoves;
+        base.MinMovesLowerBound = a.lowerBound;
+        CsvIO::writeRow(row, base);
+        std::string line = row.str();
+        line.pop_back();    // writeRow's newline; the extra columns follow
+        std::ostringstream extra;
+        extra << ',' << a.seed << ',' << a.stream << ',' << a.attempt << ',' << a.solveTimeMs << ','
+            << a.solveWeight << ',' << a.elapsedMs << ',' << a.lowerBound << ',' << a.countWorkers << ','
+            << (a.moveOrder ? 1 : 0) << '\n';
+        line += extra.str();
+
+        if (bytes > 0 && bytes + line.size() > opt.maxBytes) {
+            std::error_code ec;
+            fs::rename(filePath, filePath + ".1", ec);
+            if (ec) return false;
+            bytes = 0;
+        }
+        std::ofstream f(filePath, std::ios::binary | std::ios::app);
+        if (!f) return false;
+        if (bytes == 0) {
+            std::ostringstream header;
+            CsvIO::writeHeader(header);
+            std::string h = header.str();
+            h.pop_back();
+            h += kExtraHeader;
+            h += '\n';
+            f << h;
+            bytes += h.size();
+        }
+        f << line;
+        if (!f) return false;
+        bytes += line.size();
+        ++nextIndex;
+        ++written;
+        return true;
+    }
+
+    size_t SlowAttemptCorpus::recorded() const {
+        std::lock_guard<std::mutex> lock(m);
+        return written;
+    }
+
+    size_t SlowAttemptCorpus::sampledOut() const {
+        std::lock_guard<std::mutex> lock(m);
+        return skipped;
+    }
+
+    std::vector<SlowAttempt> SlowAttemptCorpus::load(const std::string& path, std::string* err) {
+        std::vector<SlowAttempt> out;
+        std::error_code ec;
+        const bool rolled = std::filesystem::exists(path + ".1", ec);
+        if (!std::filesystem::exists(path, ec) && !rolled) {
+            if (err) *err = "Could not open " + path + ".";
+            return out;
+        }
+        if (rolled) loadFile(path + ".1", out);
+        loadFile(path, out);
+        return out;
+    }
+
+} // namespace ws
@@ -0,0 +1,52 @@
+// ========================= src/io/SlowCorpus.hpp =========================
+#pragma once
+#include "../core/Generator.hpp"
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ws {
+
+    struct SlowCorpusOptions {
+        double thresholdMs{ 1000.0 };   // solves at least this slow are captured; failures always are
+        double sampleRate{ 1.0 };       // share of captured attempts written, 0..1
+        uint64_t maxBytes{ 16ull << 20 };// file size that triggers a roll to "<path>.1"
+    };
+
+    // Rolling corpus of slow or failed makeOne solves. The file is a library CSV (CsvIO::load
+    // reads it; DifficultyLabel holds the outcome: slow, timeout or unsolved) with extra columns:
+    //   Seed,Stream,Attempt,SolveTimeMs,SolveWeight,ElapsedMs,LowerBound,CountWorkers,MoveOrder
+    // MoveOrder records only whether a learned model was set, not which one. Index continues
+    // from the last row already on disk. When a row would push the file past maxBytes it is
+    // renamed to "<path>.1", replacing the previous generation, and a new file starts; the
+    // corpus thus keeps at most about twice maxBytes of the most recent attempts. record() is
+    // safe to call from several generators.
+    class SlowAttemptCorpus {
+    public:
+        explicit SlowAttemptCorpus(std::string path, SlowCorpusOptions opt = {});
+        const std::string& path() const { return filePath; }
+        const SlowCorpusOptions& options() const { return opt; }
+
+        // False when the attempt was sampled out or could not be written.
+        bool record(const SlowAttempt& a);
+        // Generator::setSlowAttemptSink hook bound to this corpus, which must outlive it.
+        SlowAttemptSink sink() { return [this](const SlowAttempt& a) { record(a); }; }
+        size_t recorded() const;
+        size_t sampledOut() const;
+
+        // Oldest first: the rolled "<path>.1" (when present), then `path`. Unreadable rows are skipped.
+        static std::vector<SlowAttempt> load(const std::string& path, std::string* err = nullptr);
+
+    private:
+        mutable std::mutex m;
+        std::string filePath;
+        SlowCorpusOptions opt;
+        RNG rng;
+        uint64_t bytes{ 0 };
+        int nextIndex{ 1 };
+        size_t written{ 0 };
+        size_t skipped{ 0 };
+    };
+
+} // namespace ws
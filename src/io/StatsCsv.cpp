@@ -0,0 +1,72 @@
+// ========================= src/io/StatsCsv.cpp =========================
+#include "StatsCsv.hpp"
+#include <fstream>
+
+namespace ws {
+
+    static std::string paramsKey(const Params& p) {
+        std::string key = std::to_string(p.numColors) + "c/" + std::to_string(p.numBottles) + "b/" + std::to_string(p.capacity) + "h";
+        if (p.ruleSet != RuleSetId::Classic) key += std::string("/") + ruleSetName(p.ruleSet);
+        return key;
+    }
+
+    bool StatsCsvIO::save(const std::string& path, const LibraryStats& stats, std::string* err) {
+        std::ofstream f(path, std::ios::trunc);
+        if (!f) {
+            if (err) *err = "Could not open " + path + " for writing.";
+            return false;
+        }
+        auto row = [&](const char* table, const std::string& key, const std::string& sub, double value) {
+            f << table << ',' << key << ',' << sub << ',' << value << '\n';
+        };
+        f << "Table,Key,SubKey,Value\n";
+
+        const double n = (double)stats.size();
+        row("summary", "maps", "", n);
+        row("summary", "meanScore", "", n > 0 ? stats.scoreSum / n : 0.0);
+        const double solved = (double)stats.movesSketch.count();
+        row("summary", "meanMinMoves", "", solved > 0 ? stats.movesSum / solved : 0.0);
+
+        const double qs[] = { 0.0, 0.1, 0.25, 0.5, 0.75, 0.9, 1.0 };
+        for (double q : qs) {
+            const std::string sub = "p" + std::to_string((int)(q * 100));
+            row("quantile", "DifficultyScore", sub, stats.scoreSketch.quantile(q));
+            row("quantile", "MinMoves", sub, stats.movesSketch.quantile(q));
+        }
+
+        const double scoreStep = 100.0 / LibraryStats::kScoreBins;
+        for (int s = 0; s < LibraryStats::kScoreBins; ++s) {
+            for (int m = 0; m < LibraryStats::kMovesBins; ++m) {
+                if (stats.joint[s][m] == 0) continue;
+                const std::string moves = std::to_string(m * LibraryStats::kMovesBinWidth) +
+                    (m + 1 == LibraryStats::kMovesBins ? "+" : "-" + std::to_string((m + 1) * LibraryStats::kMovesBinWidth - 1));
+                row("joint", std::to_string((int)(s * scoreStep)) + "-" + std::to_string((int)((s + 1) * scoreStep)), moves, stats.joint[s][m]);
+            }
+        }
+
+        for (const auto& pr : stats.byParams) {
+            const std::string key = paramsKey(pr.params);
+            row("labels", key, "maps", pr.maps);
+            for (int l = 0; l < LibraryStats::kLabelCount; ++l) {
+                if (pr.labels[l] > 0) row("labels", key, LibraryStats::kLabelNames[l], pr.labels[l]);
+            }
+        }
+
+        const char* kinds[] = { "none", "cloth", "vine", "bush" };
+        for (int k = 0; k < 4; ++k) {
+            if (k > 0) row("gimmick", kinds[k], "bottles", stats.gimmickBottles[k]);
+            row("gimmick", kinds[k], "maps", stats.mapsWithGimmick[k]);
+        }
+
+        for (int h = 0; h <= LibraryStats::kMaxHidden; ++h) {
+            if (stats.hiddenHistogram[h] == 0) continue;
+            row("hidden", std::to_string(h) + (h == LibraryStats::kMaxHidden ? "+" : ""), "maps", stats.hiddenHistogram[h]);
+        }
+        if (!f) {
+            if (err) *err = "Could not write " + path + ".";
+            return false;
+        }
+        return true;
+    }
+
+} // namespace ws
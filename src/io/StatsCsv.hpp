@@ -0,0 +1,15 @@
+// ========================= src/io/StatsCsv.hpp =========================
+#pragma once
+#include "../core/LibraryStats.hpp"
+#include <string>
+
+namespace ws {
+
+    // Library analytics as one long-format CSV (Table,Key,SubKey,Value) that pivots cleanly in a
+    // spreadsheet. Tables: summary, quantile, joint (score bin x moves bin), labels (per Params),
+    // gimmick and hidden.
+    struct StatsCsvIO {
+        static bool save(const std::string& path, const LibraryStats& stats, std::string* err = nullptr);
+    };
+
+} // namespace ws
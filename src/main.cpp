@@ -1,9 +1,281 @@
 // ========================= src/main.cpp =========================
 #include "ui/App.hpp"
+#include "io/HintPack.hpp"
+#include "io/LibraryDiff.hpp"
+#include "io/StatsCsv.hpp"
+#include "io/MoveOrderFile.hpp"
+#include "io/SlowCorpus.hpp"
 #include <SDL.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+// The executable is a WIN32 (GUI subsystem) target, so on Windows the headless modes start
+// without stdout/stderr. Borrow the console of the shell that launched us, if any, so their
+// summaries and errors reach it; elsewhere this does nothing.
+static void attachParentConsole() {
+#ifdef _WIN32
+    if (!AttachConsole(ATTACH_PARENT_PROCESS)) return;
+    FILE* f = nullptr;
+    freopen_s(&f, "CONOUT$", "w", stdout);
+    freopen_s(&f, "CONOUT$", "w", stderr);
+#endif
+}
+
+// Headless batch job for build servers: hint tables for every map of a CSV library.
+static int exportHints(const char* csvPath, const char* outPath, int radius) {
+    auto rows = ws::CsvIO::load(csvPath);
+    ws::HintPack pack;
+    ws::HintOptions opt;
+    opt.radius = radius;
+    int failed = 0;
+    for (const auto& r : rows) {
+        ws::State s;
+        if (!ws::CsvIO::decode(r, s)) { ++failed; continue; }
+        std::string reason;
+        auto table = ws::buildHintTable(s, opt, &reason);
+        if (!table) {
+            std::fprintf(stderr, "map %d: %s\n", r.index, reason.c_str());
+            ++failed;
+            continue;
+        }
+        pack.maps.push_back(ws::HintPackMap{ r.index, std::move(*table) });
+    }
+    std::string err;
+    if (!ws::HintPackIO::save(outPath, pack, &err)) {
+        std::fprintf(stderr, "%s\n", err.c_str());
+        return 1;
+    }
+    std::printf("Wrote hints for %d of %d maps to %s\n", (int)pack.maps.size(), (int)rows.size(), outPath);
+    return failed > 0 ? 2 : 0;
+}
+
+// Bulk edit of a CSV library: apply one transform to every map, re-solve, and write the result.
+// Maps whose edit fails to transform, solve or verify are copied through unchanged unless
+// `dropFailed` is set. The CSV carries no solutions, so every map is solved from scratch.
+static int bulkEdit(const char* csvPath, const char* outPath, const char* spec, bool dropFailed) {
+    ws::BulkTransform transform;
+    std::string err;
+    if (!ws::parseBulkTransform(spec, transform, &err)) {
+        std::fprintf(stderr, "%s\n", err.c_str());
+        return 1;
+    }
+    auto rows = ws::CsvIO::load(csvPath);
+    std::vector<ws::Generated> maps;
+    std::vector<int> rowIndex;
+    for (const auto& r : rows) {
+        ws::Generated g;
+        if (!ws::CsvIO::decode(r, g.state)) continue;
+        g.mixCount = r.MixCount; g.minMoves = r.MinMoves; g.diffScore = r.DifficultyScore; g.diffLabel = r.DifficultyLabel;
+        g.minMovesExact = r.MinMovesExact; g.minMovesLowerBound = r.MinMovesLowerBound;
+        maps.push_back(std::move(g));
+        rowIndex.push_back(r.index);
+    }
+    std::vector<int> indices(maps.size());
+    for (size_t i = 0; i < indices.size(); ++i) indices[i] = (int)i;
+    ws::BulkOptions opt;
+    opt.workers = (int)std::max(1u, std::thread::hardware_concurrency());
+    auto reports = ws::runBulkTransform(maps, indices, transform, opt);
+
+    std::vector<ws::CsvRow> out;
+    int failed = 0;
+    for (const auto& r : reports) {
+        const auto& g = maps[r.index];
+        if (r.outcome == ws::BulkOutcome::Unsolvable || r.outcome == ws::BulkOutcome::Unverified || r.outcome == ws::BulkOutcome::TransformFailed) {
+            // runBulkTransform leaves these maps as they were.
+            std::fprintf(stderr, "map %d: %s (%s), %s\n", rowIndex[r.index], ws::bulkOutcomeName(r.outcome), r.reason.c_str(),
+                dropFailed ? "dropped" : "kept unchanged");
+            ++failed;
+            if (dropFailed) continue;
+        }
+        if (r.outcome == ws::BulkOutcome::BandChanged) {
+            std::printf("map %d: %s -> %s (%d -> %d moves)\n", rowIndex[r.index], r.oldLabel.c_str(), r.newLabel.c_str(), r.oldMoves, r.newMoves);
+        }
+        out.push_back(ws::CsvIO::encode(rowIndex[r.index], g.state, g.mixCount, g.minMoves, g.diffScore, g.diffLabel));
+        out.back().MinMovesExact = g.minMovesExact;
+        out.back().MinMovesLowerBound = g.minMovesLowerBound;
+    }
+    if (!ws::CsvIO::save(outPath, out, false)) {
+        std::fprintf(stderr, "Could not write %s\n", outPath);
+        return 1;
+    }
+    std::printf("Wrote %d of %d maps to %s; %d failed the edit and were %s\n", (int)out.size(), (int)rows.size(), outPath,
+        failed, dropFailed ? "dropped" : "kept unchanged");
+    return failed > 0 ? 2 : 0;
+}
+
+// Library diff/merge: which maps were added, removed or re-scored between two CSV versions,
+// plus an optional deduplicated merge. Streams both files, so million-row libraries are fine.
+static int diffLibrary(const char* oldPath, const char* newPath, const char* reportPath, const char* mergedPath) {
+    ws::LibraryDiffOptions opt;
+    opt.workers = (int)std::max(2u, std::thread::hardware_concurrency());
+    ws::LibraryDiffSummary sum;
+    std::string err;
+    if (!ws::diffLibraries(oldPath, newPath, reportPath, mergedPath ? mergedPath : "", opt, &sum, &err)) {
+        std::fprintf(stderr, "%s\n", err.c_str());
+        return 1;
+    }
+    std::printf("old %zu rows, new %zu rows: %zu unchanged, %zu changed, %zu added, %zu removed\n",
+        sum.oldRows, sum.newRows, sum.unchanged, sum.changed, sum.added, sum.removed);
+    if (sum.duplicatesOld + sum.duplicatesNew > 0) std::printf("duplicates dropped: %zu old, %zu new\n", sum.duplicatesOld, sum.duplicatesNew);
+    if (sum.unreadable > 0) std::printf("unreadable rows skipped: %zu\n", sum.unreadable);
+    if (mergedPath) std::printf("Wrote %zu merged maps to %s\n", sum.mergedRows, mergedPath);
+    std::printf("Report: %s (%.0f ms, %zu spilled runs)\n", reportPath, sum.elapsedMs, sum.spilledRuns);
+    return sum.unreadable > 0 ? 2 : 0;
+}
+
+// Library analytics without opening the UI: same tables as the Analytics window's export.
+static int libraryStats(const char* csvPath, const char* outPath) {
+    ws::LibraryStats stats;
+    int unreadable = 0;
+    for (const auto& r : ws::CsvIO::load(csvPath)) {
+        ws::State s;
+        if (!ws::CsvIO::decode(r, s)) { ++unreadable; continue; }
+        stats.add(s, r.MinMoves, r.DifficultyScore, r.DifficultyLabel);
+    }
+    std::string err;
+    if (!ws::StatsCsvIO::save(outPath, stats, &err)) {
+        std::fprintf(stderr, "%s\n", err.c_str());
+        return 1;
+    }
+    std::printf("Wrote stats for %d maps to %s (median score %.1f, median moves %.0f)\n", (int)stats.size(), outPath,
+        stats.scoreSketch.quantile(0.5), stats.movesSketch.quantile(0.5));
+    return unreadable > 0 ? 2 : 0;
+}
+
+// Move-order training: solve every map of a library with the default solver and a 5 s budget,
+// then fit the ordering model on the states along the solutions found. Those need not be
+// optimal; maps the solver times out on are left out.
+static int trainMoveOrder(const char* csvPath, const char* outPath) {
+    std::vector<ws::State> maps;
+    for (const auto& r : ws::CsvIO::load(csvPath)) {
+        ws::State s;
+        if (ws::CsvIO::decode(r, s)) maps.push_back(std::move(s));
+    }
+    std::vector<std::vector<ws::Move>> solutions(maps.size());
+    std::atomic<size_t> next{ 0 };
+    auto work = [&]() {
+        for (size_t i; (i = next.fetch_add(1)) < maps.size();) {
+            auto res = ws::Solver(5000).solve(maps[i]);
+            if (res.solved) solutions[i] = std::move(res.solutionMoves);
+        }
+    };
+    const int threads = (int)std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; ++t) pool.emplace_back(work);
+    work();
+    for (auto& t : pool) t.join();
+
+    ws::MoveOrderTrainer trainer;
+    int solved = 0;
+    for (size_t i = 0; i < maps.size(); ++i) {
+        if (solutions[i].empty()) continue;
+        trainer.addSolution(maps[i], solutions[i]);
+        ++solved;
+    }
+    if (trainer.examples() == 0) {
+        std::fprintf(stderr, "No solved maps to train on in %s\n", csvPath);
+        return 1;
+    }
+    ws::MoveOrderTrainStats stats;
+    const auto model = trainer.train(8, 0.05f, &stats);
+    std::string err;
+    if (!ws::MoveOrderIO::save(outPath, model, &err)) {
+        std::fprintf(stderr, "%s\n", err.c_str());
+        return 1;
+    }
+    std::printf("Trained on %zu states from %d of %d maps (%.1f moves per state)\n", stats.examples, solved, (int)maps.size(),
+        (double)stats.candidates / (double)stats.examples);
+    std::printf("Solution move ranked first: %.1f%% (colour-match order %.1f%%), mean rank %.2f\n",
+        100.0 * stats.topOne, 100.0 * stats.baselineTopOne, stats.meanRank);
+    std::printf("Wrote %s\n", outPath);
+    return solved < (int)maps.size() ? 2 : 0;
+}
+
+// Replays a slow-attempt corpus as a solver benchmark: every captured input is solved again with
+// its recorded options (or `solveMs` when given) and compared with the recorded solve. The corpus
+// only notes that a move-order model was used, so attempts that had one replay with `modelPath`.
+// Exits 2 when any replay regresses against its row: a solved map goes unsolved, a solve that
+// finished now times out, or the move count grows.
+static int replayCorpus(const char* corpusPath, int solveMs, const char* modelPath) {
+    std::string err;
+    const auto attempts = ws::SlowAttemptCorpus::load(corpusPath, &err);
+    if (attempts.empty()) {
+        std::fprintf(stderr, "%s\n", err.empty() ? "The corpus holds no readable attempts." : err.c_str());
+        return 1;
+    }
+    std::optional<ws::MoveOrderModel> model;
+    if (modelPath) {
+        model = ws::MoveOrderIO::load(modelPath, &err);
+        if (!model) {
+            std::fprintf(stderr, "%s\n", err.c_str());
+            return 1;
+        }
+    }
+    else if (std::any_of(attempts.begin(), attempts.end(), [](const ws::SlowAttempt& a) { return a.moveOrder; })) {
+        std::fprintf(stderr, "Some attempts used a move-order model; pass it to replay them as recorded.\n");
+    }
+    int unsolved = 0, timedOut = 0, regressed = 0;
+    double recordedMs = 0.0, replayMs = 0.0;
+    for (size_t i = 0; i < attempts.size(); ++i) {
+        const auto& a = attempts[i];
+        const int budget = solveMs > 0 ? solveMs : a.solveTimeMs;
+        const auto t0 = std::chrono::steady_clock::now();
+        ws::Solver solver(budget, a.countWorkers, a.solveWeight);
+        if (a.moveOrder && model) solver.setMoveOrder(&*model);
+        const auto res = solver.solve(a.state);
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        recordedMs += a.elapsedMs;
+        replayMs += ms;
+        unsolved += res.solved ? 0 : 1;
+        timedOut += res.timedOut ? 1 : 0;
+        const bool worse = (a.solved && !res.solved) || (res.timedOut && !a.timedOut) ||
+            (a.solved && res.solved && res.minMoves > a.minMoves);
+        regressed += worse ? 1 : 0;
+        std::printf("%zu: seed %llu stream %u attempt %llu: recorded %.0f ms%s, replay %.0f ms%s, moves %d -> %d%s\n", i + 1,
+            (unsigned long long)a.seed, a.stream, (unsigned long long)a.attempt, a.elapsedMs, a.timedOut ? " (timeout)" : "",
+            ms, res.timedOut ? " (timeout)" : "", a.minMoves, res.minMoves, worse ? "  REGRESSED" : "");
+    }
+    std::printf("%zu attempts: recorded %.0f ms, replay %.0f ms, %d unsolved, %d timed out, %d regressed\n",
+        attempts.size(), recordedMs, replayMs, unsolved, timedOut, regressed);
+    return regressed > 0 ? 2 : 0;
+}
 
 int main(int argc, char* argv[]) {
-    (void)argc; (void)argv;
+    if (argc >= 2 && std::strncmp(argv[1], "--", 2) == 0) attachParentConsole();
+    if (argc >= 4 && std::strcmp(argv[1], "--export-hints") == 0) {
+        return exportHints(argv[2], argv[3], argc >= 5 ? std::atoi(argv[4]) : ws::HintOptions{}.radius);
+    }
+    if (argc >= 5 && std::strcmp(argv[1], "--bulk-edit") == 0) {
+        return bulkEdit(argv[2], argv[3], argv[4], argc >= 6 && std::strcmp(argv[5], "--drop-failed") == 0);
+    }
+    if (argc >= 5 && std::strcmp(argv[1], "--diff-library") == 0) {
+        return diffLibrary(argv[2], argv[3], argv[4], argc >= 6 ? argv[5] : nullptr);
+    }
+    if (argc >= 4 && std::strcmp(argv[1], "--library-stats") == 0) {
+        return libraryStats(argv[2], argv[3]);
+    }
+    if (argc >= 4 && std::strcmp(argv[1], "--train-move-order") == 0) {
+        return trainMoveOrder(argv[2], argv[3]);
+    }
+    if (argc >= 3 && std::strcmp(argv[1], "--replay-corpus") == 0) {
+        return replayCorpus(argv[2], argc >= 4 ? std::atoi(argv[3]) : 0, argc >= 5 ? argv[4] : nullptr);
+    }
     ws::AppUI app;
     return app.run();
-}
\ No newline at end of file
+}
@@ -1,5 +1,9 @@
 ﻿// ========================= src/ui/App.cpp =========================
 #include "App.hpp"
+#include "FontCache.hpp"
+#include "../io/StatsCsv.hpp"
+#include "../io/MoveOrderFile.hpp"
+#include "../io/SlowCorpus.hpp"
 #include <SDL.h>
 #include "imgui.h"
 #include "backends/imgui_impl_sdl2.h"
@@ -7,6 +11,7 @@
 #include <algorithm> // for std::clamp
 #include <array>
 #include <cstdio>
+#include <cmath>
 #include <filesystem> // for font path existence check
 #include <cstdint>
 #include <string>
@@ -94,6 +99,23 @@ namespace ws {
         return candidates;
     }
 
+    // Per-user writable location for the baked font atlas; empty when SDL cannot provide one.
+    static std::string fontAtlasCachePath() {
+        char* dir = SDL_GetPrefPath("WaterSort", "MapTool");
+        if (!dir) return {};
+        std::string path = std::string(dir) + "font_atlas.bin";
+        SDL_free(dir);
+        return path;
+    }
+
+    static std::string sessionSnapshotPath() {
+        char* dir = SDL_GetPrefPath("WaterSort", "MapTool");
+        if (!dir) return {};
+        std::string path = std::string(dir) + "session.wss";
+        SDL_free(dir);
+        return path;
+    }
+
     static bool isProblemLogLine(const std::string& line) {
         const std::string lower = toLowerCopy(line);
         return lower.find("fail") != std::string::npos ||
@@ -171,12 +193,23 @@ namespace ws {
         tpl.p = p;
         tpl.B.resize(p.numBottles);
         for (auto& b : tpl.B) b.capacity = p.capacity;
+        LabConfig runBound;
+        runBound.heuristic = SolverHeuristic::RunBound;
+        labConfigs = { LabConfig{}, runBound };
     }
 
     AppUI::~AppUI() {
+        cpuGovernor.end();   // parked workers would otherwise hold up the join
         if (generationThread.joinable()) {
             generationThread.join();
         }
+        dryRunCancel.store(true);
+        if (dryRunThread.joinable()) {
+            dryRunThread.join();
+        }
+        if (labThread.joinable()) {
+            labThread.join();   // bounded by the longest configuration's budget
+        }
     }
 
     void AppUI::setStatus(const std::string& msg) {
@@ -191,6 +224,7 @@ namespace ws {
 
     void AppUI::ensureIndex(int idx) {
         if (idx >= 0 && idx < (int)generated.size()) {
+            materialize(idx);
             currentIndex = idx;
             viewIndexInput = idx + 1;
             playbackStep = 0;
@@ -198,6 +232,129 @@ namespace ws {
         }
     }
 
+    void AppUI::materialize(int idx) {
+        if (idx < 0 || idx >= (int)sessionPending.size() || !sessionPending[idx]) return;
+        if (!session.decodeMap((size_t)idx, generated[idx])) {
+            appendGenerationLog("Session map #" + std::to_string(idx + 1) + " could not be decoded; left empty.");
+        }
+        sessionPending[idx] = 0;
+        if (--sessionPendingCount == 0) forgetSession();
+    }
+
+    void AppUI::materializeAll() {
+        for (int i = 0; sessionPendingCount > 0 && i < (int)sessionPending.size(); ++i) materialize(i);
+    }
+
+    void AppUI::forgetSession() {
+        session.close();
+        sessionPending.clear();
+        sessionPendingCount = 0;
+    }
+
+    bool AppUI::restoreSession(const std::string& path) {
+        forgetSession();
+        std::string err;
+        if (!session.open(path, &err)) {
+            setStatus("Session not restored: " + err);
+            return false;
+        }
+        // Copy out before materialize() can close the reader.
+        const SessionSettings s = session.settings();
+        p = s.params;
+        opt = s.gen;
+        NtoGenerate = s.toGenerate;
+        autoCount = s.autoCount;
+        clothCount = s.clothCount;
+        vineCount = s.vineCount;
+        bushCount = s.bushCount;
+        questionCount = s.questionCount;
+        questionMaxPerBottle = s.questionMaxPerBottle;
+        workerThreads = std::clamp(s.workerThreads, 1, workerThreadMax);
+        cpuOpt = s.cpu;
+        cpuGovernor.setOptions(cpuOpt);
+        useTemplate = s.useTemplate;
+        tpl = session.templateState();
+        if ((int)tpl.B.size() != p.numBottles) syncTemplateWithParams();
+
+        const size_t n = session.mapCount();
+        ++poolEpoch;
+        generated.clear();
+        generated.resize(n);
+        sessionPending.assign(n, 1);
+        sessionPendingCount = n;
+        currentIndex = -1;
+        viewIndexInput = 1;
+        if (n == 0) {
+            forgetSession();
+        }
+        else {
+            ensureIndex(std::clamp(s.currentIndex, 0, (int)n - 1));
+            playbackStep = s.playbackStep;   // clamped by the viewer
+            playbackScramble = s.playbackScramble;
+        }
+        setStatus("Restored session: " + std::to_string(n) + " maps.");
+        return true;
+    }
+
+    bool AppUI::saveSession(const std::string& path) {
+        SessionSettings s;
+        s.params = p;
+        s.gen = opt;
+        s.toGenerate = NtoGenerate;
+        s.autoCount = autoCount;
+        s.clothCount = clothCount;
+        s.vineCount = vineCount;
+        s.bushCount = bushCount;
+        s.questionCount = questionCount;
+        s.questionMaxPerBottle = questionMaxPerBottle;
+        s.workerThreads = workerThreads;
+        s.cpu = cpuOpt;
+        s.useTemplate = useTemplate;
+        s.currentIndex = currentIndex;
+        s.playbackStep = playbackStep;
+        s.playbackScramble = playbackScramble;
+
+        SessionWriter w;
+        w.setSettings(s);
+        w.setTemplate(tpl);
+        for (size_t i = 0; i < generated.size(); ++i) {
+            if (i < sessionPending.size() && sessionPending[i]) {
+                // Untouched since the restore: copy the record instead of decoding it.
+                const auto rec = session.encodedMap(i);
+                w.addEncodedMap(rec.first, rec.second);
+            }
+            else if (!w.addMap(generated[i])) {
+                setStatus("Session not saved: map #" + std::to_string(i + 1) + " is too large for the snapshot format.");
+                return false;
+            }
+        }
+
+        // The writer holds its own copy of the pending records, so the old mapping can go; it
+        // must, since Windows refuses to replace a mapped file. Maps keep their positions, so
+        // the pending ones are served from the new file afterwards.
+        const bool remap = sessionPendingCount > 0;
+        const std::string mappedPath = session.path();
+        session.close();
+        std::string err;
+        const bool ok = w.writeTo(path, &err);
+        if (remap) {
+            std::string reopenErr;
+            const std::string& source = ok ? path : mappedPath;
+            if (!session.open(source, &reopenErr) || session.mapCount() != generated.size()) {
+                appendGenerationLog("Session snapshot could not be re-opened: " + reopenErr);
+                session.close();
+                for (size_t i = 0; i < sessionPending.size(); ++i) if (sessionPending[i]) generated[i] = Generated{};
+                sessionPending.clear();
+                sessionPendingCount = 0;
+            }
+        }
+        if (!ok) {
+            setStatus("Session not saved: " + err);
+            return false;
+        }
+        return true;
+    }
+
     void AppUI::collectGenerated() {
         if (!isGenerating.load() && generationThread.joinable()) {
             generationThread.join();
@@ -206,15 +363,42 @@ namespace ws {
         }
 
         std::vector<Generated> newly;
+        std::vector<BulkResult> bulkDone;
+        bool bulkFinished = false;
         {
             std::lock_guard<std::mutex> lock(pendingMutex);
             if (!pendingGenerated.empty()) {
                 newly.swap(pendingGenerated);
             }
+            if (pendingBulkReady) {
+                bulkDone.swap(pendingBulk);
+                bulkReports.swap(pendingBulkReports);
+                pendingBulkReports.clear();
+                pendingBulkReady = false;
+                bulkFinished = true;
+            }
+        }
+
+        if (bulkFinished) {
+            int replaced = 0;
+            int stale = 0;
+            for (auto& r : bulkDone) {
+                // The pool may have been cleared or reloaded while the job ran.
+                if (r.index < 0 || r.index >= (int)generated.size() || makeStateKey(generated[r.index].state) != r.originalKey) {
+                    ++stale;
+                    continue;
+                }
+                generated[r.index] = std::move(r.map);
+                ++replaced;
+            }
+            if (stale > 0) setStatus("Bulk edit: " + std::to_string(stale) + " maps changed while the job ran and were left alone.");
+            if (replaced > 0 && currentIndex >= 0) playbackStep = 0;
+            if (replaced > 0) ++poolEpoch;
         }
 
         if (!newly.empty()) {
             bool hadAny = !generated.empty();
+            materializeAll();
             std::unordered_set<std::string> seen;
             seen.reserve(generated.size() + newly.size());
 
@@ -261,6 +445,13 @@ namespace ws {
         const int minBottlesForColors = std::max(3, p.numColors + 1);
         pChanged |= InputIntClamped("Bottles", &p.numBottles, minBottlesForColors, 30);
         pChanged |= InputIntClamped("Capacity", &p.capacity, 3, 50);
+        int ruleSet = (int)p.ruleSet;
+        const char* ruleSetNames[kRuleSetCount];
+        for (int i = 0; i < kRuleSetCount; ++i) ruleSetNames[i] = ruleSetName((RuleSetId)i);
+        if (ImGui::Combo("Rule set", &ruleSet, ruleSetNames, kRuleSetCount)) {
+            p.ruleSet = (RuleSetId)ruleSet;
+            pChanged = true;
+        }
         ImGui::TextDisabled("Bottles must be at least Colors + 1.");
         ImGui::Separator();
         ImGui::Text("Generator");
@@ -269,8 +460,61 @@ namespace ws {
         }
         InputIntClamped("Mix max", &opt.mixMax, opt.mixMin, 10000, 5, 20);
         InputIntClamped("Solve ms", &opt.solveTimeMs, 200, 100000, 10, 100);
+        float solveWeight = (float)opt.solveWeight;
+        if (ImGui::SliderFloat("Move bound", &solveWeight, 1.0f, 3.0f, solveWeight <= 1.0f ? "exact" : "within %.2fx")) {
+            opt.solveWeight = std::max(1.0f, solveWeight);
+        }
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("Above 1, maps are solved by weighted A*: MinMoves may exceed the optimum by up to this factor,\nbut large maps validate far faster. Each map keeps its proven lower bound.");
+        }
+        ImGui::Checkbox("Improve timed-out maps", &opt.improveOnTimeout);
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("Keep maps the solver could not finish: shorten a beam-search path window by window and store it with its lower bound.");
+        }
+        ImGui::BeginDisabled(!opt.improveOnTimeout);
+        InputIntClamped("Improve ms", &opt.improveTimeMs, 200, 100000, 10, 100);
+        ImGui::EndDisabled();
+        {
+            std::array<char, 256> pathBuf{};
+            std::snprintf(pathBuf.data(), pathBuf.size(), "%s", moveOrderPath.c_str());
+            if (ImGui::InputText("Move order", pathBuf.data(), pathBuf.size())) moveOrderPath = pathBuf.data();
+            if (ImGui::IsItemHovered()) {
+                ImGui::SetTooltip("Model from --train-move-order: the solver tries likely solution moves first.\nThe visited-state pruning depends on that order, so MinMoves can differ from an unordered solve.");
+            }
+            ImGui::BeginDisabled(isGenerating.load());
+            if (ImGui::Button("Load model")) {
+                std::string err;
+                if (auto model = MoveOrderIO::load(moveOrderPath, &err)) {
+                    opt.moveOrder = std::make_shared<const MoveOrderModel>(*model);
+                    setStatus("Loaded move order model " + moveOrderPath);
+                }
+                else setStatus(err);
+            }
+            ImGui::SameLine();
+            if (ImGui::Button("Clear model")) opt.moveOrder.reset();
+            ImGui::EndDisabled();
+            ImGui::SameLine();
+            ImGui::TextDisabled(opt.moveOrder ? "learned order" : "colour-match order");
+        }
+        ImGui::Checkbox("Capture slow solves", &captureSlow);
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("Append every solve that fails, times out or exceeds the threshold to a rolling CSV corpus.\nReplay it with --replay-corpus to benchmark solver changes on real worst cases.");
+        }
+        if (captureSlow) {
+            std::array<char, 256> pathBuf{};
+            std::snprintf(pathBuf.data(), pathBuf.size(), "%s", slowCorpusPath.c_str());
+            if (ImGui::InputText("Corpus CSV", pathBuf.data(), pathBuf.size())) slowCorpusPath = pathBuf.data();
+            int thresholdMs = (int)slowCorpusOpt.thresholdMs;
+            if (InputIntClamped("Slow above ms", &thresholdMs, 1, 600000, 50, 500)) slowCorpusOpt.thresholdMs = thresholdMs;
+            int samplePct = (int)std::lround(slowCorpusOpt.sampleRate * 100.0);
+            if (InputIntClamped("Keep %", &samplePct, 1, 100, 5, 25)) slowCorpusOpt.sampleRate = samplePct / 100.0;
+            int capMb = (int)(slowCorpusOpt.maxBytes >> 20);
+            if (InputIntClamped("Roll at MB", &capMb, 1, 4096)) slowCorpusOpt.maxBytes = (uint64_t)capMb << 20;
+            if (slowCorpus) ImGui::TextDisabled("%zu captured this session", slowCorpus->recorded());
+        }
         InputIntClamped("Worker threads", &workerThreads, 1, workerThreadMax);
-        ImGui::TextDisabled("Parallel workers use seed + worker index. Max: %d", workerThreadMax);
+        ImGui::TextDisabled("Parallel workers draw independent streams of one seed. Max: %d", workerThreadMax);
+        drawCpuCapControls();
         InputIntClamped("Count (N)", &NtoGenerate, 1, 50);
         InputIntClamped("Auto template maps", &autoCount, 1, 50);
         ImGui::Separator();
@@ -358,6 +602,20 @@ namespace ws {
         InputIntClamped("Reserved empty bottles", &opt.reservedEmpty, 0, std::max(0, p.numBottles - 1));
         InputIntClamped("Max same-color run", &opt.maxRunPerBottle, 0, p.capacity);
         ImGui::EndDisabled();
+        ImGui::BeginDisabled(opt.startMixed);
+        ImGui::Checkbox("Adaptive scramble", &opt.adaptiveScramble);
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("Stop scrambling as soon as the board is mixed enough (after Mix min steps) instead of at a\n"
+                "drawn step count. Mix max only caps the scramble: boards still unmixed after twice Mix max are skipped unsolved.");
+        }
+        if (opt.adaptiveScramble) {
+            float mixTarget = (float)opt.mixTarget;
+            if (ImGui::SliderFloat("Mix target", &mixTarget, 0.1f, 1.2f, "%.2f x random")) opt.mixTarget = mixTarget;
+            float entropyTarget = (float)opt.mixEntropyTarget;
+            if (ImGui::SliderFloat("Min bottle entropy", &entropyTarget, 0.0f, 3.0f, entropyTarget <= 0.0f ? "off" : "%.2f bits")) opt.mixEntropyTarget = entropyTarget;
+            InputIntClamped("Min solver heuristic", &opt.mixHeuristicTarget, 0, 200);
+        }
+        ImGui::EndDisabled();
         if (pChanged) syncTemplateWithParams();
 
         ImGui::Checkbox("Use template on generate", &useTemplate);
@@ -392,20 +650,28 @@ namespace ws {
                 generationCompleted.store(0);
                 isGenerating.store(true);
 
+                materializeAll();
                 std::vector<std::string> existingKeys;
+                std::vector<uint64_t> existingFingerprints;
                 existingKeys.reserve(generated.size());
+                existingFingerprints.reserve(generated.size());
                 for (const auto& item : generated) {
                     existingKeys.push_back(makeStateKey(item.state));
+                    existingFingerprints.push_back(dedupFingerprint(item.state));
                 }
 
                 int workerCount = std::min(std::max(workerThreads, 1), std::max(1, count));
-                generationThread = std::thread([this, pCopy, optCopy, tplCopy, count, useTemplateNow, workerCount, existingKeys = std::move(existingKeys)]() mutable {
+                optCopy.countWorkers = std::max(1, workerThreads / workerCount);
+                cpuGovernor.begin(workerCount);
+                generationThread = std::thread([this, pCopy, optCopy, tplCopy, corpus = slowCorpusForRun(), count, useTemplateNow, workerCount, existingKeys = std::move(existingKeys), existingFingerprints = std::move(existingFingerprints)]() mutable {
                     const auto generationStart = std::chrono::steady_clock::now();
                     appendGenerationLog("Generate N started: count=" + std::to_string(count) + ", workers=" + std::to_string(workerCount));
                     std::vector<Generated> local;
                     local.reserve(count);
                     std::unordered_set<std::string> seen(existingKeys.begin(), existingKeys.end());
                     seen.reserve(existingKeys.size() + (size_t)count * 2);
+                    CandidateIndex candidates;
+                    for (uint64_t fp : existingFingerprints) candidates.claim(fp);
 
                     std::mutex localMutex;
                     std::atomic<int> duplicateCount{ 0 };
@@ -420,16 +686,21 @@ namespace ws {
                     for (int workerIdx = 0; workerIdx < workerCount; ++workerIdx) {
 
                         GenOptions workerOpt = optCopy;
-                        workerOpt.seed = optCopy.seed + static_cast<uint64_t>(workerIdx);
+                        workerOpt.stream = static_cast<uint32_t>(workerIdx);
 
                         workers.emplace_back([&, workerOpt]() mutable {
                             Generator localGen(pCopy, workerOpt);
+                            localGen.setDedupIndex(&candidates);
+                            if (corpus) localGen.setSlowAttemptSink(corpus->sink(), corpus->options().thresholdMs);
+                            cpuGovernor.enterWorker();
                             if (useTemplateNow) {
                                 localGen.setBase(tplCopy);
                             }
 
                             while (true) {
                                 if (generationCompleted.load() >= count) break;
+                                cpuGovernor.gate((int)workerOpt.stream, [&] { return generationCompleted.load() >= count; });
+                                if (generationCompleted.load() >= count) break;
 
                                 int attemptNow = ++globalAttempts;
                                 if (attemptNow > maxAttempts) break;
@@ -468,12 +739,14 @@ namespace ws {
                                     duplicateCount.fetch_add(1);
                                 }
                             }
+                            duplicateCount.fetch_add(localGen.duplicatesSkipped());
                         });
                     }
 
                     for (auto& worker : workers) {
                         if (worker.joinable()) worker.join();
                     }
+                    cpuGovernor.end();
 
                     appendGenerationLog(
                         "Generate N finished: generated=" + std::to_string((int)local.size()) + "/" + std::to_string(count) +
@@ -544,14 +817,20 @@ namespace ws {
                 generationCompleted.store(0);
                 isGenerating.store(true);
 
+                materializeAll();
                 std::vector<std::string> existingKeys;
+                std::vector<uint64_t> existingFingerprints;
                 existingKeys.reserve(generated.size());
+                existingFingerprints.reserve(generated.size());
                 for (const auto& item : generated) {
                     existingKeys.push_back(makeStateKey(item.state));
+                    existingFingerprints.push_back(dedupFingerprint(item.state));
                 }
 
                 int workerCount = std::min(std::max(workerThreads, 1), std::max(1, count));
-                generationThread = std::thread([this, pCopy, optCopy, cloth, vine, bush, questions, count, questionMaxPerBottle = questionMaxPerBottle, workerCount, existingKeys = std::move(existingKeys)]() mutable {
+                optCopy.countWorkers = std::max(1, workerThreads / workerCount);
+                cpuGovernor.begin(workerCount);
+                generationThread = std::thread([this, pCopy, optCopy, corpus = slowCorpusForRun(), cloth, vine, bush, questions, count, questionMaxPerBottle = questionMaxPerBottle, workerCount, existingKeys = std::move(existingKeys), existingFingerprints = std::move(existingFingerprints)]() mutable {
                     const auto generationStart = std::chrono::steady_clock::now();
                     appendGenerationLog("Auto template generation started: count=" + std::to_string(count) +
                         ", workers=" + std::to_string(workerCount) +
@@ -565,6 +844,8 @@ namespace ws {
 
                     std::unordered_set<std::string> seen(existingKeys.begin(), existingKeys.end());
                     seen.reserve(existingKeys.size() + (size_t)count * 2);
+                    CandidateIndex candidates;
+                    for (uint64_t fp : existingFingerprints) candidates.claim(fp);
 
                     std::mutex localMutex;
                     std::atomic<int> duplicateCount{ 0 };
@@ -581,12 +862,17 @@ namespace ws {
                     for (int workerIdx = 0; workerIdx < workerCount; ++workerIdx) {
 
                         GenOptions workerOpt = optCopy;
-                        workerOpt.seed = optCopy.seed + static_cast<uint64_t>(workerIdx);
+                        workerOpt.stream = static_cast<uint32_t>(workerIdx);
 
                         workers.emplace_back([&, workerOpt]() mutable {
                             Generator localGen(pCopy, workerOpt);
+                            localGen.setDedupIndex(&candidates);
+                            if (corpus) localGen.setSlowAttemptSink(corpus->sink(), corpus->options().thresholdMs);
+                            cpuGovernor.enterWorker();
                             while (true) {
                                 if (generationCompleted.load() >= count) break;
+                                cpuGovernor.gate((int)workerOpt.stream, [&] { return generationCompleted.load() >= count; });
+                                if (generationCompleted.load() >= count) break;
 
                                 int attemptNow = ++globalAttempts;
                                 if (attemptNow > maxAttempts) break;
@@ -629,7 +915,7 @@ namespace ws {
                                     std::string failureLog =
                                         "Generation failure #" + std::to_string(failCountNow) +
                                         " (attempt=" + std::to_string(attemptNow) +
-                                        ", worker=" + std::to_string(workerOpt.seed - optCopy.seed) + ")";
+                                        ", worker=" + std::to_string(workerOpt.stream) + ")";
                                     if (!reason.empty()) {
                                         failureLog += ": " + reason;
                                     }
@@ -657,12 +943,14 @@ namespace ws {
                                     duplicateCount.fetch_add(1);
                                 }
                             }
+                            duplicateCount.fetch_add(localGen.duplicatesSkipped());
                         });
                     }
 
                     for (auto& worker : workers) {
                         if (worker.joinable()) worker.join();
                     }
+                    cpuGovernor.end();
 
                     appendGenerationLog(
                         "Auto template generation finished: generated=" + std::to_string((int)local.size()) + "/" + std::to_string(count) +
@@ -724,12 +1012,24 @@ namespace ws {
 
         ImGui::SameLine();
         if (ImGui::Button("Clear Memory")) {
+            forgetSession();
+            ++poolEpoch;
             generated.clear();
             currentIndex = -1;
             viewIndexInput = 1;
             playbackStep = 0;
             playbackScramble = false;
         }
+        ImGui::SameLine();
+        ImGui::BeginDisabled(sessionPath.empty());
+        if (ImGui::Button("Save Session")) {
+            if (saveSession(sessionPath)) setStatus("Session saved: " + std::to_string(generated.size()) + " maps.");
+        }
+        ImGui::SameLine();
+        ImGui::BeginDisabled(isGenerating.load());
+        if (ImGui::Button("Restore Session")) restoreSession(sessionPath);
+        ImGui::EndDisabled();
+        ImGui::EndDisabled();
 
         ImGui::Separator();
         std::array<char, 256> savePathBuf{};
@@ -742,9 +1042,12 @@ namespace ws {
             auto rowsExisting = CsvIO::load(savePath);
             int startIdx = rowsExisting.empty() ? 0 : (rowsExisting.back().index + 1);
             std::vector<CsvRow> rows;
+            materializeAll();
             for (size_t i = 0; i < generated.size(); ++i) {
                 const auto& g = generated[i];
                 rows.push_back(CsvIO::encode(startIdx + (int)i, g.state, g.mixCount, g.minMoves, g.diffScore, g.diffLabel));
+                rows.back().MinMovesExact = g.minMovesExact;
+                rows.back().MinMovesLowerBound = g.minMovesLowerBound;
             }
             CsvIO::save(savePath, rows, true);
         }
@@ -755,11 +1058,15 @@ namespace ws {
             loadPath = loadPathBuf.data();
         }
         if (ImGui::Button("Load")) {
+            forgetSession();
+            ++poolEpoch;
             generated.clear(); currentIndex = -1; viewIndexInput = 1;
             auto rows = CsvIO::load(loadPath);
             for (const auto& r : rows) {
                 State s; if (CsvIO::decode(r, s)) {
-                    Generated g; g.state = std::move(s); g.mixCount = r.MixCount; g.minMoves = r.MinMoves; g.diffScore = r.DifficultyScore; g.diffLabel = r.DifficultyLabel; generated.push_back(std::move(g));
+                    Generated g; g.state = std::move(s); g.mixCount = r.MixCount; g.minMoves = r.MinMoves; g.diffScore = r.DifficultyScore; g.diffLabel = r.DifficultyLabel;
+                    g.minMovesExact = r.MinMovesExact; g.minMovesLowerBound = r.MinMovesLowerBound;
+                    generated.push_back(std::move(g));
                 }
             }
             if (!generated.empty()) ensureIndex(0);
@@ -793,6 +1100,118 @@ namespace ws {
         if (c > 20) c = 20; return table[c];
     }
 
+    void AppUI::drawBulkEditWindow() {
+        ImGui::Begin("Bulk Edit");
+        ImGui::TextDisabled("Ops separated by ';' (bottles are 1-based):");
+        ImGui::TextDisabled("  gimmick <bottle> none|cloth|vine|bush [target]   hide <bottle> <count>   cloth <bottle> <target>");
+        std::array<char, 512> specBuf{};
+        std::snprintf(specBuf.data(), specBuf.size(), "%s", bulkSpec.c_str());
+        if (ImGui::InputText("Transform", specBuf.data(), specBuf.size())) {
+            bulkSpec = specBuf.data();
+        }
+        ImGui::Checkbox("Current map only", &bulkCurrentOnly);
+        ImGui::SameLine();
+        ImGui::Checkbox("Keep unsolvable results", &bulkKeepUnsolvable);
+
+        BulkTransform transform;
+        std::string parseError;
+        const bool parsed = parseBulkTransform(bulkSpec, transform, &parseError);
+        if (!parsed) ImGui::TextColored(ImVec4(1, 0.4f, 0.4f, 1), "%s", parseError.c_str());
+
+        std::vector<int> indices;
+        if (bulkCurrentOnly) {
+            if (currentIndex >= 0 && currentIndex < (int)generated.size()) indices.push_back(currentIndex);
+        }
+        else {
+            for (int i = 0; i < (int)generated.size(); ++i) indices.push_back(i);
+        }
+
+        const bool busy = isGenerating.load();
+        ImGui::BeginDisabled(busy || !parsed || indices.empty());
+        if (ImGui::Button("Apply and re-solve")) {
+            materializeAll();
+            std::vector<Generated> work;
+            std::vector<std::string> keys;
+            work.reserve(indices.size());
+            for (int idx : indices) {
+                work.push_back(generated[idx]);
+                keys.push_back(makeStateKey(generated[idx].state));
+            }
+            BulkOptions bulkOpt;
+            bulkOpt.solveTimeMs = opt.solveTimeMs;
+            bulkOpt.workers = workerThreads;
+            bulkOpt.keepUnsolvable = bulkKeepUnsolvable;
+
+            if (generationThread.joinable()) generationThread.join();
+            generationTotal = (int)indices.size();
+            generationCompleted.store(0);
+            isGenerating.store(true);
+            setStatus("");
+            generationThread = std::thread([this, transform, bulkOpt, indices, work = std::move(work), keys = std::move(keys)]() mutable {
+                appendGenerationLog("Bulk edit started: maps=" + std::to_string(indices.size()) + ", ops=\"" + describeBulkTransform(transform) + "\"");
+                std::vector<int> local(work.size());
+                for (size_t k = 0; k < local.size(); ++k) local[k] = (int)k;
+                auto reports = runBulkTransform(work, local, transform, bulkOpt, &generationCompleted);
+
+                std::array<int, 6> counts{};
+                std::vector<BulkResult> results;
+                for (size_t k = 0; k < reports.size(); ++k) {
+                    auto& r = reports[k];
+                    r.index = indices[k];
+                    ++counts[(size_t)r.outcome];
+                    if (r.outcome == BulkOutcome::Unsolvable || r.outcome == BulkOutcome::BandChanged) {
+                        appendGenerationLog("Bulk edit map #" + std::to_string(r.index + 1) + ": " + bulkOutcomeName(r.outcome) +
+                            " (" + r.oldLabel + " -> " + (r.newLabel.empty() ? std::string("-") : r.newLabel) + ")");
+                    }
+                    const bool rewritten = r.outcome != BulkOutcome::TransformFailed &&
+                        (bulkOpt.keepUnsolvable || (r.outcome != BulkOutcome::Unsolvable && r.outcome != BulkOutcome::Unverified));
+                    if (rewritten) results.push_back(BulkResult{ r.index, keys[k], std::move(work[k]) });
+                }
+                std::string summary = "Bulk edit finished: unchanged " + std::to_string(counts[(size_t)BulkOutcome::Unchanged]) +
+                    ", moves changed " + std::to_string(counts[(size_t)BulkOutcome::MovesChanged]) +
+                    ", band changed " + std::to_string(counts[(size_t)BulkOutcome::BandChanged]) +
+                    ", unsolvable " + std::to_string(counts[(size_t)BulkOutcome::Unsolvable]) +
+                    ", unverified " + std::to_string(counts[(size_t)BulkOutcome::Unverified]) +
+                    ", transform failed " + std::to_string(counts[(size_t)BulkOutcome::TransformFailed]);
+                appendGenerationLog(summary);
+                {
+                    std::lock_guard<std::mutex> lock(pendingMutex);
+                    pendingBulk = std::move(results);
+                    pendingBulkReports = std::move(reports);
+                    pendingBulkReady = true;
+                }
+                setStatus(summary);
+                isGenerating.store(false);
+                });
+        }
+        ImGui::EndDisabled();
+        ImGui::SameLine();
+        ImGui::TextDisabled("%d maps", (int)indices.size());
+
+        ImGui::Separator();
+        ImGui::Text("Last run");
+        ImGui::BeginChild("bulk-report", ImVec2(0, 0), true);
+        for (const auto& r : bulkReports) {
+            if (r.outcome == BulkOutcome::Unchanged) continue;
+            const bool bad = r.outcome == BulkOutcome::Unsolvable || r.outcome == BulkOutcome::Unverified || r.outcome == BulkOutcome::TransformFailed;
+            const ImVec4 col = bad ? ImVec4(1.0f, 0.4f, 0.4f, 1.0f)
+                : r.outcome == BulkOutcome::BandChanged ? ImVec4(0.9f, 0.8f, 0.3f, 1.0f) : ImVec4(0.8f, 0.8f, 0.8f, 1.0f);
+            ImGui::PushID(r.index);
+            if (ImGui::SmallButton("View")) ensureIndex(r.index);
+            ImGui::PopID();
+            ImGui::SameLine();
+            if (r.newMoves >= 0) {
+                ImGui::TextColored(col, "#%d %s: %d -> %d%s moves, %s -> %s", r.index + 1, bulkOutcomeName(r.outcome),
+                    r.oldMoves, r.newMoves, r.newMovesExact ? "" : "?", r.oldLabel.c_str(), r.newLabel.c_str());
+            }
+            else {
+                ImGui::TextColored(col, "#%d %s: %s", r.index + 1, bulkOutcomeName(r.outcome), r.reason.c_str());
+            }
+        }
+        ImGui::EndChild();
+        ImGui::End();
+    }
+
     void AppUI::drawGenerationLogWindow() {
         ImGui::Begin("Generation Logs");
 
@@ -829,6 +1248,338 @@ namespace ws {
         ImGui::End();
     }
 
+    void AppUI::drawGalleryWindow() {
+        ImGui::Begin("Gallery");
+        ImGui::SetNextItemWidth(160.0f);
+        ImGui::SliderInt("Tile width", &galleryTileWidth, 80, 320);
+        ImGui::SameLine();
+        ImGui::TextDisabled("%d maps, %d tiles rebuilt last frame", (int)generated.size(), galleryRebuildsLastFrame);
+        const int rebuildsBefore = thumbnails.rebuildCount();
+
+        const float tileW = (float)galleryTileWidth;
+        const float tileH = std::floor(tileW * 0.7f);
+        const float labelH = ImGui::GetTextLineHeightWithSpacing();
+        const float spacing = 6.0f;
+        thumbnails.resize(generated.size());
+
+        ImGui::BeginChild("GalleryGrid", ImVec2(0, 0), false);
+        const int columns = std::max(1, (int)((ImGui::GetContentRegionAvail().x + spacing) / (tileW + spacing)));
+        const int total = (int)generated.size();
+        const int rows = (total + columns - 1) / columns;
+        ImDrawList* dl = ImGui::GetWindowDrawList();
+
+        // Only rows inside the scroll view are submitted; the clipper skips the rest.
+        ImGuiListClipper clipper;
+        clipper.Begin(rows, tileH + labelH + spacing);
+        while (clipper.Step()) {
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+                for (int col = 0; col < columns; ++col) {
+                    const int i = row * columns + col;
+                    if (i >= total) break;
+                    if (col > 0) ImGui::SameLine(0.0f, spacing);
+                    materialize(i);
+                    const Generated& g = generated[i];
+
+                    ImGui::PushID(i);
+                    const ImVec2 origin = ImGui::GetCursorScreenPos();
+                    if (ImGui::InvisibleButton("tile", ImVec2(tileW, tileH + labelH))) ensureIndex(i);
+                    const bool hovered = ImGui::IsItemHovered();
+                    if (hovered) {
+                        ImGui::SetTooltip("Map #%d\nMoves: %d%s\nDifficulty: %.1f (%s)", i + 1, g.minMoves,
+                            g.minMovesExact ? "" : " (upper bound)", g.diffScore, g.diffLabel.c_str());
+                    }
+                    const ImU32 frame = i == currentIndex ? IM_COL32(250, 220, 120, 255)
+                        : hovered ? IM_COL32(120, 120, 140, 255) : IM_COL32(30, 30, 36, 255);
+                    dl->AddRectFilled(origin, ImVec2(origin.x + tileW, origin.y + tileH + labelH), IM_COL32(30, 30, 36, 255));
+                    dl->AddRect(origin, ImVec2(origin.x + tileW, origin.y + tileH + labelH), frame);
+                    ThumbnailCache::draw(dl, thumbnails.get((size_t)i, g.state, ImVec2(tileW, tileH), colorFor), origin);
+
+                    char label[64];
+                    std::snprintf(label, sizeof(label), "#%d  %d mv  %s", i + 1, g.minMoves, g.diffLabel.c_str());
+                    dl->PushClipRect(origin, ImVec2(origin.x + tileW, origin.y + tileH + labelH), true);
+                    dl->AddText(ImVec2(origin.x + 4.0f, origin.y + tileH), IM_COL32(200, 200, 200, 255), label);
+                    dl->PopClipRect();
+                    ImGui::PopID();
+                }
+            }
+        }
+        clipper.End();
+        ImGui::EndChild();
+
+        galleryRebuildsLastFrame = thumbnails.rebuildCount() - rebuildsBefore;
+        ImGui::End();
+    }
+
+    void AppUI::updateStats() {
+        // Appends are folded in row by row; anything that replaced maps in place restarts the scan.
+        if (statsEpoch != poolEpoch || statsRows > generated.size()) {
+            stats.clear();
+            statsRows = 0;
+            statsEpoch = poolEpoch;
+        }
+        Generated decoded;
+        for (; statsRows < generated.size(); ++statsRows) {
+            const size_t i = statsRows;
+            if (i < sessionPending.size() && sessionPending[i]) {
+                // Read restored maps straight from the snapshot without materializing the pool.
+                if (session.decodeMap(i, decoded)) stats.add(decoded);
+                continue;
+            }
+            stats.add(generated[i]);
+        }
+    }
+
+    void AppUI::drawAnalyticsWindow() {
+        ImGui::Begin("Analytics");
+        updateStats();
+        const double n = (double)stats.size();
+        const double solved = (double)stats.movesSketch.count();
+        ImGui::Text("%d maps   mean score %.1f   mean moves %.1f", (int)stats.size(),
+            n > 0 ? stats.scoreSum / n : 0.0, solved > 0 ? stats.movesSum / solved : 0.0);
+        if (stats.size() == 0) { ImGui::TextDisabled("No maps in the pool."); ImGui::End(); return; }
+
+        if (ImGui::CollapsingHeader("Quantiles", ImGuiTreeNodeFlags_DefaultOpen)) {
+            const double qs[] = { 0.1, 0.25, 0.5, 0.75, 0.9 };
+            if (ImGui::BeginTable("quantiles", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_SizingFixedFit)) {
+                ImGui::TableSetupColumn("");
+                for (const char* h : { "p10", "p25", "p50", "p75", "p90" }) ImGui::TableSetupColumn(h);
+                ImGui::TableHeadersRow();
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn(); ImGui::TextUnformatted("Score");
+                for (double q : qs) { ImGui::TableNextColumn(); ImGui::Text("%.1f", stats.scoreSketch.quantile(q)); }
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn(); ImGui::TextUnformatted("MinMoves");
+                for (double q : qs) { ImGui::TableNextColumn(); ImGui::Text("%.0f", stats.movesSketch.quantile(q)); }
+                ImGui::EndTable();
+            }
+        }
+
+        if (ImGui::CollapsingHeader("Difficulty score x MinMoves", ImGuiTreeNodeFlags_DefaultOpen)) {
+            const float cellSize = 16.0f;
+            const float axisW = ImGui::CalcTextSize("100").x + 6.0f;
+            ImDrawList* dl = ImGui::GetWindowDrawList();
+            const ImVec2 origin = ImGui::GetCursorScreenPos();
+            const int rows = LibraryStats::kScoreBins;
+            const int cols = LibraryStats::kMovesBins;
+            const float scoreStep = 100.0f / rows;
+            for (int sb = rows - 1; sb >= 0; --sb) {
+                const float y = origin.y + (rows - 1 - sb) * cellSize;
+                if (sb % 4 == 0) dl->AddText(ImVec2(origin.x, y), IM_COL32(160, 160, 160, 255), std::to_string((int)(sb * scoreStep)).c_str());
+                for (int mb = 0; mb < cols; ++mb) {
+                    const int count = stats.joint[sb][mb];
+                    const ImVec2 a(origin.x + axisW + mb * cellSize, y);
+                    const ImVec2 b(a.x + cellSize - 1.0f, a.y + cellSize - 1.0f);
+                    // Square-root scale so sparse cells stay visible next to the peak.
+                    const float t = count > 0 ? 0.15f + 0.85f * std::sqrt((float)count / (float)std::max(1, stats.jointMax)) : 0.0f;
+                    dl->AddRectFilled(a, b, count > 0 ? IM_COL32((int)(60 + 190 * t), (int)(80 + 120 * t), 90, 255) : IM_COL32(35, 35, 40, 255));
+                    if (ImGui::IsMouseHoveringRect(a, b)) {
+                        ImGui::SetTooltip("Score %d-%d, moves %d%s: %d maps", (int)(sb * scoreStep), (int)((sb + 1) * scoreStep),
+                            mb * LibraryStats::kMovesBinWidth, mb + 1 == cols ? "+" : ("-" + std::to_string((mb + 1) * LibraryStats::kMovesBinWidth - 1)).c_str(), count);
+                    }
+                }
+            }
+            const float axisY = origin.y + rows * cellSize + 2.0f;
+            for (int mb = 0; mb < cols; mb += 4) {
+                dl->AddText(ImVec2(origin.x + axisW + mb * cellSize, axisY), IM_COL32(160, 160, 160, 255), std::to_string(mb * LibraryStats::kMovesBinWidth).c_str());
+            }
+            ImGui::Dummy(ImVec2(axisW + cols * cellSize, rows * cellSize + ImGui::GetTextLineHeightWithSpacing() + 2.0f));
+            ImGui::TextDisabled("rows: difficulty score (bottom = 0)   columns: MinMoves");
+            const int unsolvedMaps = (int)(stats.size() - stats.movesSketch.count());
+            if (unsolvedMaps > 0) ImGui::TextDisabled("%d maps without MinMoves are not shown", unsolvedMaps);
+        }
+
+        if (ImGui::CollapsingHeader("Labels per Params")) {
+            if (ImGui::BeginTable("labels", 2 + LibraryStats::kLabelCount, ImGuiTableFlags_Borders | ImGuiTableFlags_SizingFixedFit)) {
+                ImGui::TableSetupColumn("Params");
+                ImGui::TableSetupColumn("Maps");
+                for (const char* l : LibraryStats::kLabelNames) ImGui::TableSetupColumn(l);
+                ImGui::TableHeadersRow();
+                for (const auto& pr : stats.byParams) {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%dc %db %dh%s", pr.params.numColors, pr.params.numBottles, pr.params.capacity,
+                        pr.params.ruleSet == RuleSetId::Classic ? "" : " *");
+                    ImGui::TableNextColumn(); ImGui::Text("%d", pr.maps);
+                    for (int l = 0; l < LibraryStats::kLabelCount; ++l) { ImGui::TableNextColumn(); ImGui::Text("%d", pr.labels[l]); }
+                }
+                ImGui::EndTable();
+            }
+        }
+
+        if (ImGui::CollapsingHeader("Gimmicks and '?'")) {
+            const char* kinds[] = { "Cloth", "Vine", "Bush" };
+            for (int k = 1; k < 4; ++k) {
+                ImGui::Text("%-6s %5d maps (%.0f%%), %d bottles", kinds[k - 1], stats.mapsWithGimmick[k],
+                    100.0 * stats.mapsWithGimmick[k] / n, stats.gimmickBottles[k]);
+            }
+            ImGui::Text("No gimmick: %d maps (%.0f%%)", stats.mapsWithGimmick[0], 100.0 * stats.mapsWithGimmick[0] / n);
+            float hist[LibraryStats::kMaxHidden + 1];
+            for (int h = 0; h <= LibraryStats::kMaxHidden; ++h) hist[h] = (float)stats.hiddenHistogram[h];
+            ImGui::PlotHistogram("'?' cells per map", hist, LibraryStats::kMaxHidden + 1, 0, nullptr, 0.0f, 3.402823466e+38F, ImVec2(0, 80));
+        }
+
+        ImGui::Separator();
+        std::array<char, 256> pathBuf{};
+        std::snprintf(pathBuf.data(), pathBuf.size(), "%s", statsPath.c_str());
+        if (ImGui::InputText("Stats CSV", pathBuf.data(), pathBuf.size())) statsPath = pathBuf.data();
+        if (ImGui::Button("Export")) {
+            std::string err;
+            if (StatsCsvIO::save(statsPath, stats, &err)) setStatus("Wrote library stats to " + statsPath);
+            else setStatus(err);
+        }
+        ImGui::End();
+    }
+
+    void AppUI::drawSolverLabWindow() {
+        ImGui::Begin("Solver Lab");
+        const bool running = isLabRunning.load();
+        if (!running && labThread.joinable()) labThread.join();
+
+        ImGui::BeginDisabled(running);
+        const char* heuristicNames[kSolverHeuristicCount];
+        for (int i = 0; i < kSolverHeuristicCount; ++i) heuristicNames[i] = solverHeuristicName((SolverHeuristic)i);
+        int removeAt = -1;
+        if (ImGui::BeginTable("labConfigs", 8, ImGuiTableFlags_Borders | ImGuiTableFlags_SizingFixedFit)) {
+            for (const char* h : { "#", "Heuristic", "Pruning", "TT k", "Count threads", "Budget ms", "Weight", "Order" }) ImGui::TableSetupColumn(h);
+            ImGui::TableHeadersRow();
+            for (int i = 0; i < (int)labConfigs.size(); ++i) {
+                auto& c = labConfigs[i];
+                ImGui::PushID(i);
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                if (ImGui::SmallButton("x")) removeAt = i;
+                ImGui::SameLine();
+                ImGui::Text("%d", i + 1);
+                ImGui::TableNextColumn();
+                int h = (int)c.heuristic;
+                ImGui::SetNextItemWidth(120);
+                if (ImGui::Combo("##heuristic", &h, heuristicNames, kSolverHeuristicCount)) c.heuristic = (SolverHeuristic)h;
+                ImGui::TableNextColumn(); ImGui::Checkbox("##pruning", &c.pruning);
+                ImGui::TableNextColumn(); ImGui::SetNextItemWidth(90); InputIntClamped("##tt", &c.tableLimitK, 0, 1000000, 10, 100);
+                ImGui::TableNextColumn(); ImGui::SetNextItemWidth(90); InputIntClamped("##threads", &c.countWorkers, 1, workerThreadMax);
+                if (ImGui::IsItemHovered()) ImGui::SetTooltip("Threads for counting optimal solutions after the search; the search itself runs on one.");
+                ImGui::TableNextColumn(); ImGui::SetNextItemWidth(110); InputIntClamped("##budget", &c.budgetMs, 10, 600000, 500, 5000);
+                ImGui::TableNextColumn(); ImGui::SetNextItemWidth(110);
+                ImGui::SliderFloat("##weight", &c.weight, 1.0f, 3.0f, c.weight <= 1.0f ? "exact" : "%.2fx");
+                ImGui::TableNextColumn();
+                ImGui::BeginDisabled(!opt.moveOrder);
+                ImGui::Checkbox("learned##order", &c.learnedOrder);
+                ImGui::EndDisabled();
+                ImGui::PopID();
+            }
+            ImGui::EndTable();
+        }
+        if (removeAt >= 0) labConfigs.erase(labConfigs.begin() + removeAt);
+        if (ImGui::Button("Add configuration")) labConfigs.push_back(labConfigs.empty() ? LabConfig{} : labConfigs.back());
+        ImGui::SameLine();
+        ImGui::Checkbox("One at a time", &labSequential);
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("Configurations normally run side by side; with fewer free cores than configurations\ntheir times include contention. Run them one after another for clean timings.");
+        }
+        ImGui::SameLine();
+        const bool haveMap = currentIndex >= 0 && currentIndex < (int)generated.size();
+        ImGui::BeginDisabled(!haveMap || labConfigs.empty());
+        if (ImGui::Button("Run on selected map")) {
+            materialize(currentIndex);
+            const State start = generated[currentIndex].state;
+            const std::vector<LabConfig> configs = labConfigs;
+            {
+                std::lock_guard<std::mutex> lock(labMutex);
+                labRuns.assign(configs.size(), LabRun{});
+                for (size_t i = 0; i < configs.size(); ++i) labRuns[i].config = configs[i];
+                labMapIndex = currentIndex;
+            }
+            if (labThread.joinable()) labThread.join();
+            isLabRunning.store(true);
+            labThread = std::thread([this, start, configs, model = opt.moveOrder, sequential = labSequential]() {
+                auto runOne = [&](size_t i) {
+                    const LabConfig& c = configs[i];
+                    LabRun run;
+                    run.config = c;
+                    Solver solver(c.budgetMs, c.countWorkers, c.weight);
+                    solver.setHeuristic(c.heuristic).setPruning(c.pruning).setTableLimit((size_t)c.tableLimitK * 1000).setTrace(&run.trace);
+                    if (c.learnedOrder && model) solver.setMoveOrder(model.get());
+                    const auto t0 = std::chrono::steady_clock::now();
+                    run.result = solver.solve(start);
+                    run.wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+                    run.done = true;
+                    std::lock_guard<std::mutex> lock(labMutex);
+                    labRuns[i] = std::move(run);
+                };
+                if (sequential) {
+                    for (size_t i = 0; i < configs.size(); ++i) runOne(i);
+                }
+                else {
+                    std::vector<std::thread> pool;
+                    for (size_t i = 0; i < configs.size(); ++i) pool.emplace_back(runOne, i);
+                    for (auto& t : pool) t.join();
+                }
+                isLabRunning.store(false);
+            });
+        }
+        ImGui::EndDisabled();
+        ImGui::EndDisabled();
+        if (running) { ImGui::SameLine(); ImGui::TextDisabled("running..."); }
+
+        std::lock_guard<std::mutex> lock(labMutex);
+        if (labRuns.empty()) { ImGui::TextDisabled("Pick a map in the Viewer and run the configurations on it."); ImGui::End(); return; }
+        ImGui::Separator();
+        ImGui::Text("Map #%d", labMapIndex + 1);
+        const ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_RowBg;
+        if (ImGui::BeginTable("labResults", 11, flags)) {
+            for (const char* h : { "#", "Result", "MinMoves", "Lower", "Solutions", "Nodes", "Iterations", "Search ms", "Count ms", "Peak TT", "TT memory" }) ImGui::TableSetupColumn(h);
+            ImGui::TableHeadersRow();
+            for (size_t i = 0; i < labRuns.size(); ++i) {
+                const LabRun& r = labRuns[i];
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn(); ImGui::Text("%d", (int)i + 1);
+                ImGui::TableNextColumn();
+                if (!r.done) { ImGui::TextDisabled("..."); continue; }
+                ImGui::TextUnformatted(r.result.solved ? (r.result.timedOut ? "solved, count cut" : "solved") : (r.result.timedOut ? "timed out" : "unsolved"));
+                ImGui::TableNextColumn(); ImGui::Text("%d", r.result.minMoves);
+                ImGui::TableNextColumn(); ImGui::Text("%d", r.result.lowerBound);
+                ImGui::TableNextColumn(); ImGui::Text("%d%s", r.result.distinctSolutions, r.result.solutionCountLimited ? "+" : "");
+                ImGui::TableNextColumn(); ImGui::Text("%llu", (unsigned long long)r.trace.nodes);
+                ImGui::TableNextColumn(); ImGui::Text("%d", (int)r.trace.iterations.size());
+                ImGui::TableNextColumn(); ImGui::Text("%.1f", r.trace.searchMs);
+                ImGui::TableNextColumn(); ImGui::Text("%.1f", r.trace.countMs);
+                ImGui::TableNextColumn(); ImGui::Text("%zu", r.trace.peakTableEntries);
+                ImGui::TableNextColumn(); ImGui::Text("%.1f KB", r.trace.peakTableBytes / 1024.0);
+            }
+            ImGui::EndTable();
+        }
+
+        for (size_t i = 0; i < labRuns.size(); ++i) {
+            const LabRun& r = labRuns[i];
+            if (!r.done) continue;
+            const auto& c = r.config;
+            ImGui::PushID((int)i);
+            char head[160];
+            std::snprintf(head, sizeof(head), "#%d  %s, pruning %s, TT %s, %d thread(s), %d ms%s%s", (int)i + 1,
+                solverHeuristicName(c.heuristic), c.pruning ? "on" : "off",
+                c.tableLimitK > 0 ? (std::to_string(c.tableLimitK) + "k").c_str() : "unbounded",
+                c.countWorkers, c.budgetMs, c.weight > 1.0f ? ", weighted" : "", c.learnedOrder ? ", learned order" : "");
+            if (ImGui::TreeNode("iterations", "%s", head)) {
+                if (ImGui::BeginTable("iters", 5, flags)) {
+                    for (const char* h : { "Bound", "Nodes", "TT entries", "ms", "Nodes/ms" }) ImGui::TableSetupColumn(h);
+                    ImGui::TableHeadersRow();
+                    for (const auto& it : r.trace.iterations) {
+                        ImGui::TableNextRow();
+                        ImGui::TableNextColumn(); ImGui::Text("%d", it.bound);
+                        ImGui::TableNextColumn(); ImGui::Text("%llu", (unsigned long long)it.nodes);
+                        ImGui::TableNextColumn(); ImGui::Text("%zu", it.tableEntries);
+                        ImGui::TableNextColumn(); ImGui::Text("%.2f", it.ms);
+                        ImGui::TableNextColumn(); ImGui::Text("%.0f", it.ms > 0.0 ? it.nodes / it.ms : 0.0);
+                    }
+                    ImGui::EndTable();
+                }
+                ImGui::TreePop();
+            }
+            ImGui::PopID();
+        }
+        ImGui::End();
+    }
+
     void AppUI::drawViewer() {
         ImGui::Begin("Viewer");
         if (currentIndex < 0 || currentIndex >= (int)generated.size()) { ImGui::Text("No map selected"); ImGui::End(); return; }
@@ -836,6 +1587,11 @@ namespace ws {
         const auto& baseState = g.state;
 
         ImGui::Text("Mix=%d  MinMoves=%d  Diff=%.1f (%s)", g.mixCount, g.minMoves, g.diffScore, g.diffLabel.c_str());
+        if (baseState.p.ruleSet != RuleSetId::Classic) ImGui::Text("Rules: %s", ruleSetName(baseState.p.ruleSet));
+        if (!g.minMovesExact) {
+            ImGui::TextColored(ImVec4(0.9f, 0.8f, 0.3f, 1.0f), "MinMoves is an upper bound: lower bound %d, gap %d",
+                g.minMovesLowerBound, g.minMoves - g.minMovesLowerBound);
+        }
         ImGui::Text("Difficulty breakdown:");
         ImGui::Text("  Move: %.1f  Heuristic: %.1f  Fragment: %.1f", g.difficulty.moveComponent, g.difficulty.heuristicComponent, g.difficulty.fragmentationComponent);
         ImGui::Text("  Hidden: %.1f  Empty: %.1f  Solved: %.1f", g.difficulty.hiddenComponent, g.difficulty.emptyBottleComponent, g.difficulty.solvedBottleComponent);
@@ -982,6 +1738,7 @@ namespace ws {
 
         auto& b = s.B[selBottle];
         ImGui::Text("Capacity=%d  Size=%d", b.capacity, (int)b.slots.size());
+        bool edited = false;   // any change to the pooled map restarts the Analytics scan
 
         // Gimmicks
         int kind = (int)b.gimmick.kind;
@@ -989,11 +1746,12 @@ namespace ws {
         if (ImGui::RadioButton("Cloth", kind == 1)) kind = 1; ImGui::SameLine();
         if (ImGui::RadioButton("Vine", kind == 2)) kind = 2; ImGui::SameLine();
         if (ImGui::RadioButton("Bush", kind == 3)) kind = 3;
-        b.gimmick.kind = (StackGimmickKind)kind;
+        if (b.gimmick.kind != (StackGimmickKind)kind) { b.gimmick.kind = (StackGimmickKind)kind; edited = true; }
         if (kind == 1) {
             int ct = b.gimmick.clothTarget; if (ct < 1) ct = 1; if (ct > p.numColors) ct = p.numColors;
             if (InputIntClamped("Cloth Target Color", &ct, 1, p.numColors)) {
                 b.gimmick.clothTarget = (Color)ct;
+                edited = true;
             }
         }
 
@@ -1004,15 +1762,15 @@ namespace ws {
             paintColor = std::clamp(paintColor, 1, p.numColors);
         }
         if (ImGui::Button("Push Top")) {
-            if (b.size() < b.capacity) { b.slots.push_back(Slot{ (Color)paintColor,false }); s.refreshLocks(); }
+            if (b.size() < b.capacity) { b.slots.push_back(Slot{ (Color)paintColor,false }); s.refreshLocks(); edited = true; }
         }
         ImGui::SameLine();
         if (ImGui::Button("Pop Top")) {
-            if (b.size() > 0) { b.slots.pop_back(); s.refreshLocks(); }
+            if (b.size() > 0) { b.slots.pop_back(); s.refreshLocks(); edited = true; }
         }
         ImGui::SameLine();
         if (ImGui::Button("Clear Bottle")) {
-            b.slots.clear(); s.refreshLocks();
+            b.slots.clear(); s.refreshLocks(); edited = true;
         }
 
         static int editIndex = 1; editIndex = std::clamp(editIndex, 1, std::max(1, b.capacity));
@@ -1022,8 +1780,8 @@ namespace ws {
         int slotIndex = editIndex - 1;
         if (slotIndex < (int)b.slots.size()) {
             int ec = b.slots[slotIndex].c; if (ec < 0) ec = 0; if (ec > p.numColors) ec = p.numColors;
-            if (InputIntClamped("Edit Slot Color (0 = empty)", &ec, 0, p.numColors)) { b.slots[slotIndex].c = (Color)ec; s.refreshLocks(); }
-            bool h = b.slots[slotIndex].hidden; if (ImGui::Checkbox("? Hidden", &h)) { b.slots[slotIndex].hidden = h; }
+            if (InputIntClamped("Edit Slot Color (0 = empty)", &ec, 0, p.numColors)) { b.slots[slotIndex].c = (Color)ec; s.refreshLocks(); edited = true; }
+            bool h = b.slots[slotIndex].hidden; if (ImGui::Checkbox("? Hidden", &h)) { b.slots[slotIndex].hidden = h; edited = true; }
         }
         else {
             ImGui::TextDisabled("(Index beyond current height)");
@@ -1035,10 +1793,11 @@ namespace ws {
             bool h = (k < (int)b.slots.size()) ? b.slots[k].hidden : false;
             std::string lbl = "? slot " + std::to_string(k + 1);
             if (ImGui::Checkbox(lbl.c_str(), &h)) {
-                if (k < (int)b.slots.size()) { b.slots[k].hidden = h; s.refreshLocks(); }
+                if (k < (int)b.slots.size()) { b.slots[k].hidden = h; s.refreshLocks(); edited = true; }
             }
         }
 
+        if (edited) ++poolEpoch;
         ImGui::End();
     }
 
@@ -1051,6 +1810,51 @@ namespace ws {
         }
     }
 
+    void AppUI::drawCpuCapControls() {
+        bool changed = false;
+        int mode = (int)cpuOpt.mode;
+        const char* modeNames[kCpuCapModeCount];
+        for (int i = 0; i < kCpuCapModeCount; ++i) modeNames[i] = cpuCapModeName((CpuCapMode)i);
+        if (ImGui::Combo("CPU cap", &mode, modeNames, kCpuCapModeCount)) {
+            cpuOpt.mode = (CpuCapMode)mode;
+            changed = true;
+        }
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("Parks generation workers between attempts to stay within the cap, re-checked every half second.\nIdle cores only leaves whatever other applications are using, plus the headroom, alone.");
+        }
+        const int cores = CpuGovernor::logicalCores();
+        if (cpuOpt.mode == CpuCapMode::Share) {
+            int pct = (int)std::lround(cpuOpt.share * 100.0);
+            if (InputIntClamped("Machine %", &pct, 5, 100, 5, 25)) { cpuOpt.share = pct / 100.0; changed = true; }
+        }
+        else if (cpuOpt.mode == CpuCapMode::Cores) {
+            changed |= InputIntClamped("Cores", &cpuOpt.cores, 1, cores);
+        }
+        else if (cpuOpt.mode == CpuCapMode::IdleOnly) {
+            float headroom = (float)cpuOpt.headroom;
+            if (ImGui::SliderFloat("Headroom cores", &headroom, 0.0f, (float)cores, "%.1f")) { cpuOpt.headroom = headroom; changed = true; }
+        }
+        changed |= ImGui::Checkbox("Low priority workers", &cpuOpt.lowPriority);
+        if (changed) cpuGovernor.setOptions(cpuOpt);
+
+        const CpuUsage u = cpuGovernor.usage();
+        if (u.machineCores >= 0.0) ImGui::TextDisabled("CPU: job %.1f, machine %.1f of %d cores", u.processCores, u.machineCores, u.logicalCores);
+        else ImGui::TextDisabled("CPU: job %.1f of %d cores", u.processCores, u.logicalCores);
+        if (u.workers > 0) {
+            ImGui::SameLine();
+            if (u.partialDuty > 0.0) ImGui::TextDisabled("| workers %d + %.0f%% of %d", u.allowedWorkers, u.partialDuty * 100.0, u.workers);
+            else ImGui::TextDisabled("| workers %d of %d", u.allowedWorkers, u.workers);
+        }
+    }
+
+    std::shared_ptr<SlowAttemptCorpus> AppUI::slowCorpusForRun() {
+        if (!captureSlow) return nullptr;
+        const bool same = slowCorpus && slowCorpus->path() == slowCorpusPath && slowCorpus->options().thresholdMs == slowCorpusOpt.thresholdMs &&
+            slowCorpus->options().sampleRate == slowCorpusOpt.sampleRate && slowCorpus->options().maxBytes == slowCorpusOpt.maxBytes;
+        if (!same) slowCorpus = std::make_shared<SlowAttemptCorpus>(slowCorpusPath, slowCorpusOpt);
+        return slowCorpus;
+    }
+
     void AppUI::drawTemplate() {
         ImGui::Begin("Template (pre-generate)");
         ImGui::Text("Set start 'Height' and 'Gimmick'");
@@ -1099,9 +1903,211 @@ namespace ws {
         long long expected = 1ll * p.numColors * p.capacity;
         ImGui::Text("Sum heights: %lld / expected %lld", sumH, expected);
 
+        drawDryRunSection();
+        drawLayoutSearchSection();
         ImGui::End();
     }
 
+    static std::string formatDuration(double ms) {
+        if (!std::isfinite(ms)) return "unbounded";
+        char buf[64];
+        if (ms < 1000.0) std::snprintf(buf, sizeof(buf), "%.0f ms", ms);
+        else if (ms < 120000.0) std::snprintf(buf, sizeof(buf), "%.1f s", ms / 1000.0);
+        else if (ms < 7200000.0) std::snprintf(buf, sizeof(buf), "%.1f min", ms / 60000.0);
+        else std::snprintf(buf, sizeof(buf), "%.1f h", ms / 3600000.0);
+        return buf;
+    }
+
+    void AppUI::drawDryRunSection() {
+        ImGui::Separator();
+        ImGui::Text("Dry run (yield estimate)");
+        if (!isDryRunning.load() && dryRunThread.joinable()) dryRunThread.join();
+
+        long long sumH = 0; for (const auto& bx : tpl.B) sumH += (int)bx.slots.size();
+        const bool templateOk = sumH == 1ll * p.numColors * p.capacity;
+        if (ImGui::RadioButton("This template", !dryRunAuto)) dryRunAuto = false; ImGui::SameLine();
+        if (ImGui::RadioButton("Auto template settings", dryRunAuto)) dryRunAuto = true;
+        InputIntClamped("Max samples", &dryRunOpt.maxSamples, 10, 5000, 10, 100);
+        int budgetSec = dryRunOpt.timeBudgetMs / 1000;
+        if (InputIntClamped("Max seconds", &budgetSec, 1, 600)) dryRunOpt.timeBudgetMs = budgetSec * 1000;
+        int scalePct = (int)std::lround(dryRunOpt.budgetScale * 100.0);
+        if (InputIntClamped("Solve budget %", &scalePct, 5, 100, 5, 25)) dryRunOpt.budgetScale = scalePct / 100.0;
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("Share of 'Solve ms' each sampled attempt gets. Maps needing more count as failures, so acceptance is a lower bound.");
+        }
+
+        const bool running = isDryRunning.load();
+        ImGui::BeginDisabled(running || (!dryRunAuto && !templateOk));
+        if (ImGui::Button("Dry run")) {
+            DryRunTemplate source;
+            if (dryRunAuto) {
+                source.kind = DryRunTemplate::Kind::Auto;
+                source.cloth = clothCount;
+                source.vine = vineCount;
+                source.bush = bushCount;
+                source.questions = questionCount;
+                source.questionMaxPerBottle = questionMaxPerBottle;
+            }
+            else {
+                source.kind = DryRunTemplate::Kind::Fixed;
+                source.fixed = tpl;
+            }
+            DryRunOptions runOpt = dryRunOpt;
+            runOpt.workers = std::max(1, workerThreads);
+            runOpt.batchCount = dryRunAuto ? autoCount : NtoGenerate;
+            Params pCopy = p;
+            GenOptions optCopy = opt;
+            const std::string label = (dryRunAuto ? std::string("auto template, ") : std::string("template editor, ")) +
+                std::to_string(runOpt.batchCount) + " maps on " + std::to_string(runOpt.workers) + " workers";
+
+            if (dryRunThread.joinable()) dryRunThread.join();
+            dryRunCancel.store(false);
+            isDryRunning.store(true);
+            dryRunThread = std::thread([this, pCopy, optCopy, source = std::move(source), runOpt, label]() {
+                auto est = estimateTemplateYield(pCopy, optCopy, source, runOpt, &dryRunCancel);
+                appendGenerationLog("Dry run (" + label + "): accepted " + std::to_string(est.accepted) + "/" + std::to_string(est.attempts) +
+                    ", per map " + formatDuration(est.msPerAccepted.estimate) + ", batch " + formatDuration(est.batchMs.estimate));
+                {
+                    std::lock_guard<std::mutex> lock(dryRunMutex);
+                    dryRunResult = std::move(est);
+                    dryRunSource = label;
+                }
+                isDryRunning.store(false);
+                });
+        }
+        ImGui::EndDisabled();
+        if (!dryRunAuto && !templateOk) {
+            ImGui::SameLine();
+            ImGui::TextDisabled("(template heights must sum to Colors*Capacity)");
+        }
+        if (running) {
+            ImGui::SameLine();
+            if (ImGui::Button("Stop")) dryRunCancel.store(true);
+            ImGui::SameLine();
+            ImGui::TextColored(ImVec4(0.9f, 0.8f, 0.3f, 1.0f), "Sampling...");
+        }
+
+        std::lock_guard<std::mutex> lock(dryRunMutex);
+        if (!dryRunResult) return;
+        const auto& e = *dryRunResult;
+        ImGui::TextDisabled("%s | %d attempts in %s at %d ms solve budget%s", dryRunSource.c_str(), e.attempts,
+            formatDuration(e.elapsedMs).c_str(), e.sampleSolveMs, e.precise ? "" : " (stopped on a cap)");
+        ImGui::Text("Acceptance: %.1f%% (95%% CI %.1f-%.1f%%)", e.acceptance.estimate * 100.0, e.acceptance.low * 100.0, e.acceptance.high * 100.0);
+        ImGui::Text("Time per accepted map: %s (%s - %s)", formatDuration(e.msPerAccepted.estimate).c_str(),
+            formatDuration(e.msPerAccepted.low).c_str(), formatDuration(e.msPerAccepted.high).c_str());
+        const bool slow = !std::isfinite(e.batchMs.estimate) || e.msPerAccepted.estimate > 3600000.0;
+        ImGui::TextColored(slow ? ImVec4(1, 0.4f, 0.4f, 1) : ImVec4(0.6f, 1, 0.6f, 1), "Batch estimate: %s (%s - %s)",
+            formatDuration(e.batchMs.estimate).c_str(), formatDuration(e.batchMs.low).c_str(), formatDuration(e.batchMs.high).c_str());
+        if (e.accepted > 0) {
+            ImGui::Text("Mean min moves: %.1f", e.meanMinMoves);
+            for (const auto& [label, count] : e.labels) {
+                ImGui::BulletText("%s: %d (%.0f%%)", label.c_str(), count, 100.0 * count / e.accepted);
+            }
+        }
+        if (!e.failures.empty()) {
+            ImGui::Text("Failure reasons:");
+            for (size_t i = 0; i < e.failures.size() && i < 4; ++i) {
+                ImGui::BulletText("%d x %s", e.failures[i].second, e.failures[i].first.c_str());
+            }
+        }
+    }
+
+    void AppUI::drawLayoutSearchSection() {
+        ImGui::Separator();
+        ImGui::Text("Layout search");
+        ImGui::SameLine();
+        ImGui::TextDisabled("(?)");
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("Moves cells, gimmicks and '?' flags of this template around and samples each layout like a dry run,\n"
+                "keeping the layouts that make maps of the chosen band in the least CPU time. Heights sum and gimmick counts never change.");
+        }
+
+        static const char* bands[] = { "Any", "Very Easy", "Easy", "Normal", "Hard", "Very Hard" };
+        int band = 0;
+        for (int i = 1; i < 6; ++i) if (layoutOpt.targetBand == bands[i]) band = i;
+        if (ImGui::Combo("Target band", &band, bands, 6)) layoutOpt.targetBand = band == 0 ? std::string() : std::string(bands[band]);
+        InputIntClamped("Samples per layout", &layoutOpt.samplesPerLayout, 8, 1000, 8, 32);
+        InputIntClamped("Max layouts", &layoutOpt.maxLayouts, 2, 5000, 10, 100);
+        int budgetSec = layoutOpt.timeBudgetMs / 1000;
+        if (InputIntClamped("Search seconds", &budgetSec, 5, 7200, 10, 60)) layoutOpt.timeBudgetMs = budgetSec * 1000;
+        ImGui::BeginDisabled(!opt.startMixed);
+        ImGui::Checkbox("Heights", &layoutOpt.moveHeights);
+        ImGui::EndDisabled();
+        if (!opt.startMixed && ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled)) {
+            ImGui::SetTooltip("Start mixed is off: maps start from the solved board, so template heights are not used.");
+        }
+        ImGui::SameLine();
+        ImGui::Checkbox("Gimmicks", &layoutOpt.moveGimmicks); ImGui::SameLine();
+        ImGui::Checkbox("'?' slots", &layoutOpt.moveHidden);
+        const bool moveHeights = layoutOpt.moveHeights && opt.startMixed;
+
+        long long sumH = 0; for (const auto& bx : tpl.B) sumH += (int)bx.slots.size();
+        const bool templateOk = sumH == 1ll * p.numColors * p.capacity;
+        const bool running = isDryRunning.load();
+        ImGui::BeginDisabled(running || !templateOk || (!moveHeights && !layoutOpt.moveGimmicks && !layoutOpt.moveHidden));
+        if (ImGui::Button("Search layouts")) {
+            LayoutSearchOptions runOpt = layoutOpt;
+            runOpt.workers = std::max(1, workerThreads);
+            runOpt.budgetScale = dryRunOpt.budgetScale;
+            Params pCopy = p;
+            GenOptions optCopy = opt;
+            State seed = tpl;
+
+            if (dryRunThread.joinable()) dryRunThread.join();
+            dryRunCancel.store(false);
+            isDryRunning.store(true);
+            {
+                std::lock_guard<std::mutex> lock(dryRunMutex);
+                layoutProgress = "Sampling the current layout...";
+            }
+            dryRunThread = std::thread([this, pCopy, optCopy, seed = std::move(seed), runOpt]() {
+                auto res = optimizeTemplateLayout(pCopy, optCopy, seed, runOpt, &dryRunCancel,
+                    [this](const LayoutCandidate& c, int evaluated) {
+                        std::lock_guard<std::mutex> lock(dryRunMutex);
+                        layoutProgress = std::to_string(evaluated) + " layouts sampled, best " + formatDuration(c.msPerTarget) + " per target map";
+                    });
+                std::string summary = "Layout search: " + std::to_string(res.evaluated) + " layouts in " + formatDuration(res.elapsedMs);
+                if (!res.best.empty()) {
+                    summary += ", per target map " + formatDuration(res.start.msPerTarget) + " -> " + formatDuration(res.best.front().msPerTarget);
+                }
+                appendGenerationLog(summary);
+                {
+                    std::lock_guard<std::mutex> lock(dryRunMutex);
+                    layoutProgress.clear();
+                    layoutResult = std::move(res);
+                }
+                isDryRunning.store(false);
+                });
+        }
+        ImGui::EndDisabled();
+
+        std::lock_guard<std::mutex> lock(dryRunMutex);
+        if (running && !layoutProgress.empty()) {
+            ImGui::SameLine();
+            ImGui::TextColored(ImVec4(0.9f, 0.8f, 0.3f, 1.0f), "%s", layoutProgress.c_str());
+        }
+        if (!layoutResult) return;
+        const auto& r = *layoutResult;
+        ImGui::TextDisabled("%d layouts sampled (%d repeats skipped, %d restarts) in %s%s", r.evaluated, r.cacheHits, r.restarts,
+            formatDuration(r.elapsedMs).c_str(), r.cancelled ? ", stopped" : "");
+        auto row = [&](const char* name, const LayoutCandidate& c) {
+            ImGui::Text("%s: %d/%d in band, %d accepted, %s per target map, mean %.1f moves", name, c.inBand, c.attempts, c.accepted,
+                formatDuration(c.msPerTarget).c_str(), c.meanMinMoves);
+        };
+        if (r.start.attempts == 0) return;
+        row("Start", r.start);
+        for (size_t i = 0; i < r.best.size(); ++i) {
+            ImGui::PushID((int)i);
+            if (ImGui::SmallButton("Use")) {
+                tpl = r.best[i].layout;
+                setStatus("Template replaced by layout #" + std::to_string(i + 1) + " of the search.");
+            }
+            ImGui::SameLine();
+            row(("#" + std::to_string(i + 1)).c_str(), r.best[i]);
+            ImGui::PopID();
+        }
+    }
+
     int AppUI::run() {
         // SDL2 init
         SDL_Init(SDL_INIT_VIDEO);
@@ -1115,21 +2121,44 @@ namespace ws {
         ImGui::StyleColorsDark();
 
         // 한글 폰트 로드: 사용자/시스템 경로를 폭넓게 시도합니다.
+        // The Korean ranges are ~11k glyphs; a baked atlas from an earlier run is reused when the
+        // font file, size and ranges are unchanged, so only the first start pays for rasterising.
+        const float fontSize = 18.0f;
+        const ImWchar* koreanRanges = io.Fonts->GetGlyphRangesKorean();
+        const std::string fontCache = fontAtlasCachePath();
         const std::vector<std::string> fontCandidates = buildKoreanFontCandidates();
         ImFont* korean = nullptr;
+        bool fontFromCache = false;
+        FontCacheKey fontKey;
         for (const std::string& path : fontCandidates) {
-            korean = io.Fonts->AddFontFromFileTTF(path.c_str(), 18.0f, nullptr, io.Fonts->GetGlyphRangesKorean());
+            std::error_code ec;
+            if (!std::filesystem::exists(path, ec)) continue;
+            fontKey = FontCacheKey{};
+            const bool keyed = makeFontCacheKey(path, fontSize, koreanRanges, fontKey);
+            if (keyed && !fontCache.empty()) {
+                korean = FontAtlasCache::load(fontCache, fontKey, io.Fonts);
+                fontFromCache = korean != nullptr;
+            }
+            if (!korean) korean = io.Fonts->AddFontFromFileTTF(path.c_str(), fontSize, nullptr, koreanRanges);
             if (korean) { io.FontDefault = korean; break; }
         }
         if (!korean) {
             // 최후 수단: 기본 폰트(라틴 위주). 이 경우 한글은 깨져 보일 수 있습니다.
             korean = io.Fonts->AddFontDefault();
             io.FontDefault = korean;
+            fontKey.fontPath.clear();
             printf("[ImGui] Korean font NOT found, using default font. Tried common system/user font paths.\n");
         }
 
         // (옵션) 즉시 폰트 아틀라스 빌드 — 백엔드 init 전에 하면 자동으로 반영됩니다.
-        io.Fonts->Build();
+        // A cached atlas is already built and has no source data to rebuild from.
+        if (!fontFromCache) {
+            io.Fonts->Build();
+            if (!fontKey.fontPath.empty() && !fontCache.empty()) {
+                std::string why;
+                if (!FontAtlasCache::save(fontCache, fontKey, io.Fonts, &why)) printf("[ImGui] Font cache not written: %s\n", why.c_str());
+            }
+        }
 
         // 2) 백엔드 초기화
         ImGui_ImplSDL2_InitForSDLRenderer(window, renderer);
@@ -1139,6 +2168,10 @@ namespace ws {
         ImGui_ImplSDLRenderer2_DestroyFontsTexture();
         ImGui_ImplSDLRenderer2_CreateFontsTexture();
 
+        // Pick up where the last run left off; maps decode lazily as they are viewed.
+        sessionPath = sessionSnapshotPath();
+        if (!sessionPath.empty() && std::filesystem::exists(sessionPath)) restoreSession(sessionPath);
+
         bool running = true; SDL_Event e;
         while (running) {
             while (SDL_PollEvent(&e)) {
@@ -1154,6 +2187,10 @@ namespace ws {
             drawViewer();
             drawEditor();
             drawGenerationLogWindow();
+            drawBulkEditWindow();
+            drawGalleryWindow();
+            drawAnalyticsWindow();
+            drawSolverLabWindow();
 
             ImGui::Render();
             SDL_SetRenderDrawColor(renderer, 20, 20, 24, 255);
@@ -1162,6 +2199,8 @@ namespace ws {
             SDL_RenderPresent(renderer);
         }
 
+        if (!sessionPath.empty() && !saveSession(sessionPath)) printf("[Session] %s\n", getStatus().c_str());
+
         ImGui_ImplSDLRenderer2_Shutdown();
         ImGui_ImplSDL2_Shutdown();
         ImGui::DestroyContext();
@@ -1,7 +1,15 @@
 ﻿// ========================= src/ui/App.hpp =========================
 #pragma once
 #include "../core/Generator.hpp"
+#include "../core/BulkEdit.hpp"
+#include "../core/YieldEstimator.hpp"
+#include "../core/TemplateOptimizer.hpp"
+#include "../core/LibraryStats.hpp"
+#include "../core/CpuGovernor.hpp"
 #include "../io/Csv.hpp"
+#include "../io/Session.hpp"
+#include "../io/SlowCorpus.hpp"
+#include "Thumbnails.hpp"
 #include <atomic>
 #include <mutex>
 #include <string>
@@ -32,6 +40,17 @@ namespace ws {
         bool playbackScramble{ false };
         std::string savePath{ "maps.csv" };
         std::string loadPath{ "maps.csv" };
+        std::string moveOrderPath{ "move_order.wsmo" };
+        // Slow-solve capture: a generation run shares one corpus across its workers; a settings
+        // change starts a new corpus object (the file itself keeps growing and rolling).
+        bool captureSlow{ false };
+        std::string slowCorpusPath{ "slow_attempts.csv" };
+        SlowCorpusOptions slowCorpusOpt;
+        std::shared_ptr<SlowAttemptCorpus> slowCorpus;
+        // CPU cap for generation runs: one governor serves every run; the controls edit cpuOpt
+        // and push it over, so a change also applies to the run in progress.
+        CpuGovernorOptions cpuOpt;
+        CpuGovernor cpuGovernor;
         State tpl;                 // 생성용 템플릿(병별 초기 높이 + 기믹)
         bool useTemplate{ true };    // Generate 시 템플릿 사용 여부
         std::string statusMessage;  // last user‑visible status/error
@@ -44,18 +63,104 @@ namespace ws {
         std::vector<Generated> pendingGenerated;
         std::thread generationThread;
 
+        // Bulk edit: runs on generationThread; results are swapped in by collectGenerated()
+        // only where the pool still holds the map the job started from.
+        struct BulkResult { int index; std::string originalKey; Generated map; };
+        std::string bulkSpec{ "gimmick 3 bush" };
+        bool bulkCurrentOnly{ false };
+        bool bulkKeepUnsolvable{ false };
+        std::vector<BulkReport> bulkReports;
+        std::vector<BulkResult> pendingBulk;        // guarded by pendingMutex
+        std::vector<BulkReport> pendingBulkReports; // guarded by pendingMutex
+        bool pendingBulkReady{ false };             // guarded by pendingMutex
+
+        // Template dry run (Template window): own thread so it can run next to a generation job.
+        DryRunOptions dryRunOpt;
+        bool dryRunAuto{ false };          // sample the auto-template settings instead of the template editor
+        std::thread dryRunThread;
+        std::atomic<bool> isDryRunning{ false };
+        std::atomic<bool> dryRunCancel{ false };
+        std::mutex dryRunMutex;
+        std::optional<YieldEstimate> dryRunResult; // guarded by dryRunMutex
+        std::string dryRunSource;                  // guarded by dryRunMutex
+
+        // Layout search (Template window): runs on dryRunThread, so it never overlaps a dry run.
+        LayoutSearchOptions layoutOpt;
+        std::optional<LayoutSearchResult> layoutResult; // guarded by dryRunMutex
+        std::string layoutProgress;                     // guarded by dryRunMutex
+
+        // Session snapshot: restored maps stay encoded in the mapped file until first used.
+        std::string sessionPath;           // SDL pref path; empty when unavailable
+        SessionReader session;
+        std::vector<uint8_t> sessionPending; // 1 while generated[i] is still an empty placeholder
+        size_t sessionPendingCount{ 0 };
+
+        // Gallery: per-map quads cached by content digest, so only changed maps are re-laid out.
+        ThumbnailCache thumbnails;
+        int galleryTileWidth{ 160 };
+        int galleryRebuildsLastFrame{ 0 };
+
+        // Analytics: folded in row by row as the pool grows; a poolEpoch bump (clear, load,
+        // restore, bulk swap, Editor change) restarts the scan.
+        LibraryStats stats;
+        size_t statsRows{ 0 };
+        uint64_t poolEpoch{ 0 };
+        uint64_t statsEpoch{ 0 };
+        std::string statsPath{ "library_stats.csv" };
+
+        // Solver Lab: every configuration solves the chosen map on its own thread (or one after
+        // another), started from labThread; the window reads labRuns under labMutex.
+        struct LabConfig {
+            SolverHeuristic heuristic{ SolverHeuristic::Fragmentation };
+            bool pruning{ true };
+            int tableLimitK{ 0 };       // transposition entries in thousands, 0 = unbounded
+            int countWorkers{ 1 };
+            int budgetMs{ 5000 };
+            float weight{ 1.0f };
+            bool learnedOrder{ false };
+        };
+        struct LabRun {
+            LabConfig config;
+            SolveResult result;
+            SolveTrace trace;
+            double wallMs{ 0.0 };
+            bool done{ false };
+        };
+        std::vector<LabConfig> labConfigs;
+        bool labSequential{ false };    // one configuration at a time, for contention-free timings
+        std::thread labThread;
+        std::atomic<bool> isLabRunning{ false };
+        std::mutex labMutex;
+        std::vector<LabRun> labRuns;    // guarded by labMutex
+        int labMapIndex{ -1 };          // guarded by labMutex
+
         // UI helpers
         void drawTopBar();
         void drawEditor();
         void drawViewer();
         void drawTemplate();           // 템플릿 편집창
         void drawGenerationLogWindow();
+        void drawBulkEditWindow();
+        void drawGalleryWindow();
+        void drawAnalyticsWindow();
+        void drawSolverLabWindow();
+        void updateStats();
         void syncTemplateWithParams(); // Colors/Bottles/Capacity 바뀔 때 템플릿 맞춰주기
+        void drawDryRunSection();
+        void drawLayoutSearchSection();
+        std::shared_ptr<SlowAttemptCorpus> slowCorpusForRun();
+        void drawCpuCapControls();
         void collectGenerated();
         void setStatus(const std::string& msg);
         std::string getStatus();
 
         void ensureIndex(int idx);
+
+        bool restoreSession(const std::string& path);
+        bool saveSession(const std::string& path);
+        void materialize(int idx);      // decode one restored map if still pending
+        void materializeAll();          // before anything that walks the whole pool
+        void forgetSession();           // pool replaced wholesale; unmap the snapshot
     };
 
 } // namespace ws
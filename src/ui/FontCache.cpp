@@ -0,0 +1,210 @@
+// ========================= src/ui/FontCache.cpp =========================
+#include "FontCache.hpp"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+namespace ws {
+
+    static const char kFontMagic[8] = { 'W','S','F','O','N','T','0','1' };
+
+    namespace {
+
+        struct Writer {
+            std::vector<uint8_t> bytes;
+            void u(uint64_t v, int n) { for (int i = 0; i < n; ++i) bytes.push_back((uint8_t)(v >> (8 * i))); }
+            void f(float v) { uint32_t b; std::memcpy(&b, &v, 4); u(b, 4); }
+            void str(const std::string& s) { u(s.size(), 4); bytes.insert(bytes.end(), s.begin(), s.end()); }
+        };
+
+        struct Reader {
+            const std::vector<uint8_t>& bytes;
+            size_t pos{ 0 };
+            bool ok{ true };
+            bool need(size_t n) { if (pos + n > bytes.size()) ok = false; return ok; }
+            uint64_t u(int n) {
+                if (!need((size_t)n)) return 0;
+                uint64_t v = 0;
+                for (int i = 0; i < n; ++i) v |= uint64_t(bytes[pos + i]) << (8 * i);
+                pos += (size_t)n;
+                return v;
+            }
+            float f() { uint32_t b = (uint32_t)u(4); float v; std::memcpy(&v, &b, 4); return v; }
+            std::string str() {
+                const size_t n = (size_t)u(4);
+                if (!need(n)) return {};
+                std::string s(bytes.begin() + (long)pos, bytes.begin() + (long)(pos + n));
+                pos += n;
+                return s;
+            }
+        };
+
+        void writeKey(Writer& w, const FontCacheKey& k) {
+            w.str(k.fontPath);
+            w.f(k.sizePixels);
+            w.u((uint64_t)k.fontMtime, 8);
+            w.u(k.fontBytes, 8);
+            w.u(k.rangesHash, 8);
+        }
+
+    } // namespace
+
+    bool makeFontCacheKey(const std::string& path, float sizePixels, const ImWchar* ranges, FontCacheKey& out) {
+        std::error_code ec;
+        const auto bytes = std::filesystem::file_size(path, ec);
+        if (ec) return false;
+        const auto mtime = std::filesystem::last_write_time(path, ec);
+        if (ec) return false;
+        uint64_t h = 1469598103934665603ull;
+        for (const ImWchar* r = ranges; r && *r; ++r) {
+            h ^= (uint64_t)*r;
+            h *= 1099511628211ull;
+        }
+        out.fontPath = path;
+        out.sizePixels = sizePixels;
+        out.fontMtime = (int64_t)mtime.time_since_epoch().count();
+        out.fontBytes = (uint64_t)bytes;
+        out.rangesHash = h;
+        return true;
+    }
+
+    bool FontAtlasCache::save(const std::string& cachePath, const FontCacheKey& key, const ImFontAtlas* atlas, std::string* reason) {
+        auto fail = [&](const std::string& why) {
+            if (reason) *reason = why;
+            return false;
+        };
+        if (!atlas || atlas->Fonts.Size != 1 || !atlas->TexPixelsAlpha8 || atlas->TexWidth <= 0 || atlas->TexHeight <= 0) {
+            return fail("Atlas is not a built single-font alpha8 atlas.");
+        }
+        const ImFont* font = atlas->Fonts[0];
+
+        Writer w;
+        w.bytes.assign(kFontMagic, kFontMagic + 8);
+        w.u(IMGUI_VERSION_NUM, 4);
+        writeKey(w, key);
+
+        w.u((uint32_t)atlas->TexWidth, 4);
+        w.u((uint32_t)atlas->TexHeight, 4);
+        w.f(atlas->TexUvScale.x); w.f(atlas->TexUvScale.y);
+        w.f(atlas->TexUvWhitePixel.x); w.f(atlas->TexUvWhitePixel.y);
+        w.u(IM_DRAWLIST_TEX_LINES_WIDTH_MAX + 1, 4);
+        for (const auto& l : atlas->TexUvLines) { w.f(l.x); w.f(l.y); w.f(l.z); w.f(l.w); }
+
+        w.f(font->FontSize);
+        w.f(font->Ascent);
+        w.f(font->Descent);
+        // The TAB glyph is derived from SPACE by BuildLookupTable(), so it is not stored.
+        uint32_t glyphCount = 0;
+        for (const auto& g : font->Glyphs) if (g.Codepoint != '\t') ++glyphCount;
+        w.u(glyphCount, 4);
+        for (const auto& g : font->Glyphs) {
+            if (g.Codepoint == '\t') continue;
+            w.u(g.Codepoint, 4);
+            w.u((g.Colored ? 1u : 0u) | (g.Visible ? 2u : 0u), 1);
+            w.f(g.AdvanceX);
+            w.f(g.X0); w.f(g.Y0); w.f(g.X1); w.f(g.Y1);
+            w.f(g.U0); w.f(g.V0); w.f(g.U1); w.f(g.V1);
+        }
+        const size_t pixels = (size_t)atlas->TexWidth * (size_t)atlas->TexHeight;
+        w.bytes.insert(w.bytes.end(), atlas->TexPixelsAlpha8, atlas->TexPixelsAlpha8 + pixels);
+
+        // Write to a temp file and rename so a crash mid-write never leaves a torn cache behind.
+        const std::string tmp = cachePath + ".tmp";
+        {
+            std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+            if (!f) return fail("Could not open " + tmp + " for writing.");
+            f.write(reinterpret_cast<const char*>(w.bytes.data()), (std::streamsize)w.bytes.size());
+            if (!f) return fail("Could not write " + tmp + ".");
+        }
+        std::error_code ec;
+        std::filesystem::rename(tmp, cachePath, ec);
+        if (ec) return fail("Could not replace " + cachePath + ": " + ec.message());
+        return true;
+    }
+
+    ImFont* FontAtlasCache::load(const std::string& cachePath, const FontCacheKey& key, ImFontAtlas* atlas, std::string* reason) {
+        auto fail = [&](const std::string& why) -> ImFont* {
+            if (reason) *reason = why;
+            return nullptr;
+        };
+        if (!atlas || atlas->Fonts.Size != 0) return fail("Atlas must be empty.");
+        std::ifstream f(cachePath, std::ios::binary);
+        if (!f) return fail("No font cache at " + cachePath + ".");
+        const std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+
+        if (bytes.size() < 12 || std::memcmp(bytes.data(), kFontMagic, 8) != 0) return fail("Not a font cache.");
+        Reader r{ bytes };
+        r.pos = 8;
+        if (r.u(4) != IMGUI_VERSION_NUM) return fail("Font cache was written by another ImGui version.");
+        Writer expected;
+        writeKey(expected, key);
+        if (!r.need(expected.bytes.size()) || std::memcmp(&bytes[r.pos], expected.bytes.data(), expected.bytes.size()) != 0) {
+            return fail("Font cache is stale (font, size or glyph ranges changed).");
+        }
+        r.pos += expected.bytes.size();
+
+        const int width = (int)r.u(4);
+        const int height = (int)r.u(4);
+        ImVec2 uvScale, uvWhite;
+        uvScale.x = r.f(); uvScale.y = r.f();
+        uvWhite.x = r.f(); uvWhite.y = r.f();
+        if (r.u(4) != IM_DRAWLIST_TEX_LINES_WIDTH_MAX + 1) return fail("Font cache line table size mismatch.");
+        ImVec4 lines[IM_DRAWLIST_TEX_LINES_WIDTH_MAX + 1];
+        for (auto& l : lines) { l.x = r.f(); l.y = r.f(); l.z = r.f(); l.w = r.f(); }
+        const float fontSize = r.f();
+        const float ascent = r.f();
+        const float descent = r.f();
+        const uint32_t glyphCount = (uint32_t)r.u(4);
+        if (!r.ok || width <= 0 || height <= 0 || glyphCount == 0 || glyphCount >= 0xFFFF) return fail("Font cache header is corrupt.");
+        const size_t glyphBytes = 4 + 1 + 9 * 4;
+        const size_t pixels = (size_t)width * (size_t)height;
+        if (bytes.size() - r.pos != glyphBytes * glyphCount + pixels) return fail("Font cache size mismatch.");
+
+        // Same shape AddFontFromFileTTF + Build would leave behind, minus the source font data.
+        ImFontConfig cfg;
+        cfg.FontData = nullptr;
+        cfg.FontDataSize = 0;
+        cfg.FontDataOwnedByAtlas = false;
+        cfg.SizePixels = key.sizePixels;
+        std::snprintf(cfg.Name, sizeof(cfg.Name), "%s (cached)", std::filesystem::path(key.fontPath).filename().string().c_str());
+        ImFont* font = IM_NEW(ImFont);
+        cfg.DstFont = font;
+        atlas->ConfigData.push_back(cfg);
+        atlas->Fonts.push_back(font);
+
+        font->ContainerAtlas = atlas;
+        font->ConfigData = &atlas->ConfigData[0];
+        font->ConfigDataCount = 1;
+        font->FontSize = fontSize;
+        font->Ascent = ascent;
+        font->Descent = descent;
+        font->Glyphs.resize((int)glyphCount);
+        for (uint32_t i = 0; i < glyphCount; ++i) {
+            ImFontGlyph& g = font->Glyphs[(int)i];
+            g.Codepoint = (unsigned int)r.u(4);
+            const unsigned flags = (unsigned)r.u(1);
+            g.Colored = (flags & 1u) ? 1 : 0;
+            g.Visible = (flags & 2u) ? 1 : 0;
+            g.AdvanceX = r.f();
+            g.X0 = r.f(); g.Y0 = r.f(); g.X1 = r.f(); g.Y1 = r.f();
+            g.U0 = r.f(); g.V0 = r.f(); g.U1 = r.f(); g.V1 = r.f();
+        }
+        font->BuildLookupTable();
+
+        atlas->TexWidth = width;
+        atlas->TexHeight = height;
+        atlas->TexUvScale = uvScale;
+        atlas->TexUvWhitePixel = uvWhite;
+        for (int i = 0; i <= IM_DRAWLIST_TEX_LINES_WIDTH_MAX; ++i) atlas->TexUvLines[i] = lines[i];
+        atlas->TexPixelsAlpha8 = (unsigned char*)IM_ALLOC(pixels);
+        std::memcpy(atlas->TexPixelsAlpha8, &bytes[r.pos], pixels);
+        // No custom rects were packed, so the software mouse cursor shapes are unavailable.
+        atlas->Flags |= ImFontAtlasFlags_NoMouseCursors;
+        atlas->TexReady = true;
+        return font;
+    }
+
+} // namespace ws
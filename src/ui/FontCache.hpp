@@ -0,0 +1,34 @@
+// ========================= src/ui/FontCache.hpp =========================
+#pragma once
+#include "imgui.h"
+#include <cstdint>
+#include <string>
+
+namespace ws {
+
+    // What a cached atlas was built from; any difference means the cache is stale.
+    struct FontCacheKey {
+        std::string fontPath;
+        float sizePixels{ 0.0f };
+        int64_t fontMtime{ 0 };
+        uint64_t fontBytes{ 0 };
+        uint64_t rangesHash{ 0 };   // hash of the glyph range list passed to AddFontFromFileTTF
+    };
+
+    // Key for `path` at `sizePixels` with the given zero-terminated glyph ranges; false when the
+    // font file cannot be stat'ed.
+    bool makeFontCacheKey(const std::string& path, float sizePixels, const ImWchar* ranges, FontCacheKey& out);
+
+    // Baked single-font atlas on disk: alpha8 pixels, UV constants and the glyph table, so a
+    // restart skips rasterising the glyph ranges. Written for ImGui 1.91 atlas internals; the
+    // file records IMGUI_VERSION_NUM and is ignored by any other version.
+    struct FontAtlasCache {
+        // Fills an empty `atlas` from the cache file and returns the font, or nullptr (with
+        // `reason`) when the file is missing, stale or unreadable. The atlas is then marked
+        // built, so Build() must not be called on it.
+        static ImFont* load(const std::string& cachePath, const FontCacheKey& key, ImFontAtlas* atlas, std::string* reason = nullptr);
+        // Writes a built atlas holding exactly one font.
+        static bool save(const std::string& cachePath, const FontCacheKey& key, const ImFontAtlas* atlas, std::string* reason = nullptr);
+    };
+
+} // namespace ws
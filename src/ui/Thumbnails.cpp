@@ -0,0 +1,105 @@
+// ========================= src/ui/Thumbnails.cpp =========================
+#include "Thumbnails.hpp"
+#include <algorithm>
+
+namespace ws {
+
+    namespace {
+
+        struct QuadBuilder {
+            Thumbnail& t;
+            ImVec2 uv;
+            void quad(float x0, float y0, float x1, float y1, ImU32 col) {
+                if (x1 <= x0 || y1 <= y0) return;
+                const ImDrawIdx base = (ImDrawIdx)t.vertices.size();
+                t.vertices.push_back(ImDrawVert{ ImVec2(x0, y0), uv, col });
+                t.vertices.push_back(ImDrawVert{ ImVec2(x1, y0), uv, col });
+                t.vertices.push_back(ImDrawVert{ ImVec2(x1, y1), uv, col });
+                t.vertices.push_back(ImDrawVert{ ImVec2(x0, y1), uv, col });
+                const ImDrawIdx idx[6] = { 0, 1, 2, 0, 2, 3 };
+                for (ImDrawIdx i : idx) t.indices.push_back((ImDrawIdx)(base + i));
+            }
+        };
+
+        ImU32 outlineFor(const Bottle& b, Palette palette) {
+            switch (b.gimmick.kind) {
+            case StackGimmickKind::Cloth: return palette(b.gimmick.clothTarget);
+            case StackGimmickKind::Vine: return IM_COL32(90, 200, 90, 255);
+            case StackGimmickKind::Bush: return IM_COL32(250, 220, 120, 255);
+            default: return IM_COL32(200, 200, 200, 255);
+            }
+        }
+
+        // Same picture as the viewer, reduced to flat quads: outline, empty cells, coloured
+        // cells, and a light centre dot on '?' cells.
+        void build(Thumbnail& t, const State& s, ImVec2 size, Palette palette) {
+            t.vertices.clear();
+            t.indices.clear();
+            t.size = size;
+            QuadBuilder q{ t, ImGui::GetFontTexUvWhitePixel() };
+            const int n = (int)s.B.size();
+            if (n == 0) return;
+            int maxCap = 1;
+            for (const auto& b : s.B) maxCap = std::max(maxCap, b.capacity);
+            const float gap = std::max(1.0f, size.x * 0.015f);
+            const float bottleW = (size.x - gap * (n + 1)) / (float)n;
+            const float cell = (size.y - 2.0f * gap) / (float)maxCap;
+            const float inset = cell > 6.0f ? 1.0f : 0.0f;
+            const float bottom = size.y - gap;
+            for (int i = 0; i < n; ++i) {
+                const Bottle& b = s.B[i];
+                const float x0 = gap + i * (bottleW + gap);
+                const float x1 = x0 + bottleW;
+                const float top = bottom - b.capacity * cell;
+                q.quad(x0 - 1.0f, top - 1.0f, x1 + 1.0f, bottom + 1.0f, outlineFor(b, palette));
+                for (int k = 0; k < b.capacity; ++k) {
+                    const float y1 = bottom - k * cell;
+                    const float y0 = y1 - cell;
+                    ImU32 col = IM_COL32(40, 40, 40, 255);
+                    if (k < b.size()) col = b.slots[k].hidden ? IM_COL32(90, 90, 90, 255) : palette(b.slots[k].c);
+                    q.quad(x0 + inset, y0 + inset, x1 - inset, y1 - inset, col);
+                    if (k < b.size() && b.slots[k].hidden) {
+                        const float d = std::min(bottleW, cell) * 0.18f;
+                        const float cx = (x0 + x1) * 0.5f, cy = (y0 + y1) * 0.5f;
+                        q.quad(cx - d, cy - d, cx + d, cy + d, IM_COL32(220, 220, 220, 255));
+                    }
+                }
+            }
+        }
+
+    } // namespace
+
+    uint64_t thumbnailDigest(const State& s) {
+        uint64_t h = 0xcbf29ce484222325ull;
+        auto mix = [&](uint64_t v) { h ^= v; h *= 0x100000001b3ull; };
+        mix(s.B.size());
+        for (const auto& b : s.B) {
+            mix((uint64_t)b.capacity | (uint64_t)b.gimmick.kind << 8 | (uint64_t)b.gimmick.clothTarget << 16 | (uint64_t)b.slots.size() << 24);
+            for (const auto& slot : b.slots) mix((uint64_t)slot.c | (slot.hidden ? 0x100u : 0u));
+        }
+        return h;
+    }
+
+    const Thumbnail& ThumbnailCache::get(size_t slot, const State& s, ImVec2 size, Palette palette) {
+        if (slot >= tiles.size()) tiles.resize(slot + 1);
+        Thumbnail& t = tiles[slot];
+        const uint64_t digest = thumbnailDigest(s);
+        if (!t.built || t.digest != digest || t.size.x != size.x || t.size.y != size.y) {
+            build(t, s, size, palette);
+            t.digest = digest;
+            t.built = true;
+            ++rebuilds;
+        }
+        return t;
+    }
+
+    void ThumbnailCache::draw(ImDrawList* dl, const Thumbnail& t, ImVec2 origin) {
+        if (t.indices.empty()) return;
+        dl->PrimReserve((int)t.indices.size(), (int)t.vertices.size());
+        // PrimReserve may start a new vertex offset, so read the base index after it.
+        const unsigned int base = dl->_VtxCurrentIdx;
+        for (ImDrawIdx i : t.indices) dl->PrimWriteIdx((ImDrawIdx)(base + i));
+        for (const auto& v : t.vertices) dl->PrimWriteVtx(ImVec2(origin.x + v.pos.x, origin.y + v.pos.y), v.uv, v.col);
+    }
+
+} // namespace ws
@@ -0,0 +1,41 @@
+// ========================= src/ui/Thumbnails.hpp =========================
+#pragma once
+#include "../core/State.hpp"
+#include "imgui.h"
+#include <cstdint>
+#include <vector>
+
+namespace ws {
+
+    using Palette = ImU32 (*)(Color);
+
+    // Prebuilt draw geometry for one map at a fixed tile size, in tile-local coordinates.
+    struct Thumbnail {
+        uint64_t digest{ 0 };
+        ImVec2 size{};
+        bool built{ false };
+        std::vector<ImDrawVert> vertices;
+        std::vector<ImDrawIdx> indices;
+    };
+
+    // Content digest of everything a thumbnail shows (cells, '?' flags, capacities, gimmicks).
+    uint64_t thumbnailDigest(const State& s);
+
+    // One Thumbnail per pool slot. A slot is rebuilt only when its map's digest or the tile size
+    // changes, so redrawing an unchanged gallery copies vertices instead of laying out rects.
+    class ThumbnailCache {
+    public:
+        const Thumbnail& get(size_t slot, const State& s, ImVec2 size, Palette palette);
+        void resize(size_t slots) { tiles.resize(slots); }
+        void clear() { tiles.clear(); }
+        int rebuildCount() const { return rebuilds; }
+
+        // Appends the prebuilt triangles to `dl`, offset to `origin`.
+        static void draw(ImDrawList* dl, const Thumbnail& t, ImVec2 origin);
+
+    private:
+        std::vector<Thumbnail> tiles;
+        int rebuilds{ 0 };
+    };
+
+} // namespace ws